@@ -1,7 +1,8 @@
 /**
  * Print out the Abc's file node headers and structural information.
  * This will recurse through all nodes in the file, printing basic information.
- * This will NOT go through the binary per-frame data.
+ * It then reads a bounded number of per-frame samples of the geometry and
+ * xform properties (see alembic_samples.h).
  *
  * Running through this successfully will strongly indicate that the Alembic
  * archive is valid and complete.
@@ -16,6 +17,7 @@
 #include <Alembic/AbcGeom/All.h>
 #include <Alembic/AbcMaterial/All.h>
 
+#include "alembic_samples.h"
 #include "fuzz_utils.h"
 
 using Alembic::AbcCoreAbstract::PropertyHeader;
@@ -50,6 +52,15 @@ using Alembic::AbcGeom::V2fArraySamplePtr;
 using Alembic::AbcMaterial::IMaterial;
 using Alembic::AbcMaterial::IMaterialSchema;
 
+// Bounds on the per-frame data read for each input.
+const size_t kMaxSamplesPerProperty = 16;
+const size_t kSampleCacheBytes = 16 << 20;
+
+// Number of shader parameter properties read per archive. Look-dev files can
+// hold thousands of them.
+const size_t kMaxMaterialProperties = 4096;
+static size_t materialPropertyBudget;
+
 void printMeshAttributes(const IPolyMeshSchema& schema) {
   const size_t meshPropertyCount = schema.getNumProperties();
   std::cout << "  Mesh Property Count: " << meshPropertyCount << ".\n";
@@ -217,6 +228,7 @@ void printMaterial(const IObject& node) {
   IMaterialSchema& schema = material.getSchema();
 
   std::vector<std::string> targetNames;
+  schema.getTargetNames(targetNames);
   size_t targetCount = targetNames.size();
   std::cout << "  Target Count: " << targetCount << "\n";
 
@@ -238,6 +250,9 @@ void printMaterial(const IObject& node) {
           schema.getShaderParameters(targetNames[t], shaderTypes[s]);
       const size_t parameterCount = parameters.getNumProperties();
       std::cout << "    Shader Parameter Count: " << parameterCount << "\n";
+      std::cout << "    Shader Parameter Values Read: "
+                << readPropertyValues(parameters, &materialPropertyBudget)
+                << "\n";
     }
   }
 }
@@ -284,7 +299,14 @@ void printInfo(const char* file) {
 
   if (fileValid) {
     std::cout << "file name: " << archive.getName() << "\n";
+    materialPropertyBudget = kMaxMaterialProperties;
     printNodes(archive.getTop());
+
+    ArraySampleCache cache(kSampleCacheBytes);
+    size_t samples =
+        readSamples(archive.getTop(), &cache, kMaxSamplesPerProperty);
+    std::cout << "Samples read: " << samples << ", cache hits: "
+              << cache.hits() << "\n";
   }
 }
 
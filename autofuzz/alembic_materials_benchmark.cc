@@ -0,0 +1,105 @@
+// Material network load time benchmark for Alembic archives.
+//
+// Walks every IMaterial in the archive the way alembic_fuzzer's
+// printMaterial() does, but without a property budget: every target, shader
+// type and shader parameter value, plus the parameters of every network node.
+// Reports the load time and parameter values/sec per archive.
+//
+// Usage: alembic_materials_benchmark file.abc...
+
+#include <stdio.h>
+
+#include <exception>
+#include <string>
+#include <vector>
+
+#include <Alembic/AbcCoreFactory/All.h>
+#include <Alembic/AbcMaterial/All.h>
+
+#include "alembic_samples.h"
+#include "bench_utils.h"
+
+using Alembic::Abc::IArchive;
+using Alembic::Abc::ICompoundProperty;
+using Alembic::Abc::IObject;
+using Alembic::AbcCoreFactory::IFactory;
+using Alembic::AbcMaterial::IMaterial;
+using Alembic::AbcMaterial::IMaterialSchema;
+
+namespace {
+
+struct Stats {
+  size_t materials = 0;
+  size_t values = 0;
+};
+
+void loadMaterial(const IObject& node, Stats* stats) {
+  IMaterial material(node.getParent(), node.getHeader().getName());
+  IMaterialSchema& schema = material.getSchema();
+  size_t budget = (size_t)-1;
+
+  std::vector<std::string> targetNames;
+  schema.getTargetNames(targetNames);
+  for (size_t t = 0; t < targetNames.size(); t++) {
+    std::vector<std::string> shaderTypes;
+    schema.getShaderTypesForTarget(targetNames[t], shaderTypes);
+    for (size_t s = 0; s < shaderTypes.size(); s++) {
+      ICompoundProperty parameters =
+          schema.getShaderParameters(targetNames[t], shaderTypes[s]);
+      if (parameters.valid()) {
+        stats->values += readPropertyValues(parameters, &budget);
+      }
+    }
+  }
+
+  const size_t nodeCount = schema.getNumNetworkNodes();
+  for (size_t n = 0; n < nodeCount; n++) {
+    IMaterialSchema::NetworkNode networkNode = schema.getNetworkNode(n);
+    if (!networkNode.valid()) continue;
+    ICompoundProperty parameters = networkNode.getParameters();
+    if (parameters.valid()) {
+      stats->values += readPropertyValues(parameters, &budget);
+    }
+  }
+
+  stats->materials++;
+}
+
+void loadMaterials(const IObject& node, Stats* stats) {
+  if (IMaterial::matches(node.getHeader())) loadMaterial(node, stats);
+
+  const size_t childCount = node.getNumChildren();
+  for (size_t i = 0; i < childCount; i++) {
+    loadMaterials(node.getChild(i), stats);
+  }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  printf("%-40s %10s %10s %12s %12s\n", "file", "materials", "values",
+         "load ms", "values/s");
+  for (int i = 1; i < argc; i++) {
+    try {
+      IFactory factory;
+      IArchive archive = factory.getArchive(argv[i]);
+      if (!archive.valid()) {
+        fprintf(stderr, "%s: not a valid archive\n", argv[i]);
+        continue;
+      }
+
+      Stats stats;
+      double start = bench_now();
+      loadMaterials(archive.getTop(), &stats);
+      double seconds = bench_now() - start;
+
+      printf("%-40s %10zu %10zu %12.2f %12.0f\n", argv[i], stats.materials,
+             stats.values, seconds * 1e3,
+             seconds > 0 ? stats.values / seconds : 0);
+    } catch (const std::exception& e) {
+      fprintf(stderr, "%s: %s\n", argv[i], e.what());
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,198 @@
+// Archive open latency benchmark for Alembic, built on alembic_fuzzer's
+// printInfo() flow (IFactory::getArchive() then getTop()).
+//
+// For each archive the following are timed separately:
+//   open:   getArchive() and getTop();
+//   list:   the headers of the top-level objects, via getChildHeader(), which
+//           does not construct the children;
+//   lazy:   every object header in the tree, constructing IObjects only to
+//           descend and never building a schema;
+//   eager:  the same walk on a freshly opened archive, also constructing the
+//           schema of every polymesh, subd, curves and xform, as a fully
+//           populated scene would.
+//
+// Without file arguments, Ogawa archives of 10 to 100k xforms are written to
+// the -d directory first and measured instead.
+//
+// Usage: alembic_open_benchmark [-d dir] [-r repeats] [file.abc...]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <exception>
+#include <string>
+#include <vector>
+
+#include <Alembic/AbcCoreFactory/All.h>
+#include <Alembic/AbcCoreOgawa/All.h>
+#include <Alembic/AbcGeom/All.h>
+
+#include "bench_utils.h"
+
+using Alembic::Abc::IArchive;
+using Alembic::Abc::IObject;
+using Alembic::Abc::OArchive;
+using Alembic::Abc::OObject;
+using Alembic::AbcCoreFactory::IFactory;
+using Alembic::AbcGeom::ICurves;
+using Alembic::AbcGeom::IPolyMesh;
+using Alembic::AbcGeom::ISubD;
+using Alembic::AbcGeom::IXform;
+using Alembic::AbcGeom::ObjectHeader;
+using Alembic::AbcGeom::OXform;
+using Alembic::AbcGeom::XformSample;
+
+namespace {
+
+const size_t kObjectCounts[] = {10, 100, 1000, 10000, 100000};
+
+// Objects are grouped 100 to a top-level group, like a scene of assets.
+const size_t kGroupSize = 100;
+
+struct Timings {
+  size_t objects = 0;
+  double open = 0;
+  double list = 0;
+  double lazy = 0;
+  double eager = 0;
+};
+
+std::string writeArchive(const std::string& dir, size_t objects) {
+  std::string path = dir + "/objects_" + std::to_string(objects) + ".abc";
+  OArchive archive(Alembic::AbcCoreOgawa::WriteArchive(), path);
+  OObject top = archive.getTop();
+
+  XformSample sample;
+  sample.setTranslation(Imath::V3d(1, 2, 3));
+  for (size_t g = 0; g * kGroupSize < objects; g++) {
+    OXform group(top, "group_" + std::to_string(g));
+    group.getSchema().set(sample);
+    for (size_t i = 1; i < kGroupSize && g * kGroupSize + i < objects; i++) {
+      OXform child(group, "xform_" + std::to_string(i));
+      child.getSchema().set(sample);
+    }
+  }
+  return path;
+}
+
+size_t walkHeaders(const IObject& node) {
+  size_t count = 1;
+  const size_t childCount = node.getNumChildren();
+  for (size_t i = 0; i < childCount; i++) {
+    node.getChildHeader(i).getFullName();
+    count += walkHeaders(node.getChild(i));
+  }
+  return count;
+}
+
+void buildSchema(const IObject& node) {
+  const ObjectHeader& header = node.getHeader();
+  if (IPolyMesh::matches(header)) {
+    IPolyMesh(node.getParent(), header.getName()).getSchema().getNumSamples();
+  } else if (ISubD::matches(header)) {
+    ISubD(node.getParent(), header.getName()).getSchema().getNumSamples();
+  } else if (ICurves::matches(header)) {
+    ICurves(node.getParent(), header.getName()).getSchema().getNumSamples();
+  } else if (IXform::matches(header)) {
+    IXform(node.getParent(), header.getName()).getSchema().getNumOps();
+  }
+}
+
+void walkEager(const IObject& node) {
+  buildSchema(node);
+  const size_t childCount = node.getNumChildren();
+  for (size_t i = 0; i < childCount; i++) walkEager(node.getChild(i));
+}
+
+// Returns false if file is not a valid archive.
+bool measure(const char* file, Timings* t) {
+  double start = bench_now();
+  IFactory factory;
+  IArchive archive = factory.getArchive(file);
+  if (!archive.valid()) return false;
+  IObject top = archive.getTop();
+  double opened = bench_now();
+
+  const size_t childCount = top.getNumChildren();
+  for (size_t i = 0; i < childCount; i++) top.getChildHeader(i).getName();
+  double listed = bench_now();
+
+  t->objects = walkHeaders(top);
+  double lazy = bench_now();
+
+  // The lazy walk leaves the headers and child objects cached in the
+  // archive, so the eager walk starts over on a new one.
+  IArchive fresh = factory.getArchive(file);
+  if (!fresh.valid()) return false;
+  IObject freshTop = fresh.getTop();
+  double eagerStart = bench_now();
+  walkEager(freshTop);
+  double eager = bench_now();
+
+  t->open += opened - start;
+  t->list += listed - opened;
+  t->lazy += lazy - listed;
+  t->eager += eager - eagerStart;
+  return true;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  std::string dir = "/dev/shm";
+  int repeats = 5;
+  int opt;
+  while ((opt = getopt(argc, argv, "d:r:")) != -1) {
+    switch (opt) {
+      case 'd':
+        dir = optarg;
+        break;
+      case 'r':
+        repeats = atoi(optarg);
+        break;
+      default:
+        fprintf(stderr, "usage: %s [-d dir] [-r repeats] [file.abc...]\n",
+                argv[0]);
+        return 1;
+    }
+  }
+  if (repeats < 1) repeats = 1;
+
+  std::vector<std::string> files(argv + optind, argv + argc);
+  try {
+    if (files.empty()) {
+      for (size_t objects : kObjectCounts) {
+        files.push_back(writeArchive(dir, objects));
+      }
+    }
+  } catch (const std::exception& e) {
+    fprintf(stderr, "writing archives: %s\n", e.what());
+    return 1;
+  }
+
+  printf("%-40s %8s %10s %10s %10s %10s\n", "file", "objects", "open ms",
+         "list ms", "lazy ms", "eager ms");
+  for (const std::string& file : files) {
+    Timings t;
+    bool valid = true;
+    try {
+      for (int r = 0; r < repeats && valid; r++) {
+        valid = measure(file.c_str(), &t);
+      }
+    } catch (const std::exception& e) {
+      fprintf(stderr, "%s: %s\n", file.c_str(), e.what());
+      continue;
+    }
+    if (!valid) {
+      fprintf(stderr, "%s: skipped: not a valid archive\n", file.c_str());
+      continue;
+    }
+
+    printf("%-40s %8zu %10.3f %10.3f %10.3f %10.3f\n", file.c_str(),
+           t.objects, t.open * 1e3 / repeats, t.list * 1e3 / repeats,
+           t.lazy * 1e3 / repeats, t.eager * 1e3 / repeats);
+  }
+
+  return 0;
+}
@@ -0,0 +1,215 @@
+#include "alembic_samples.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <Alembic/AbcGeom/All.h>
+
+using Alembic::Abc::IArrayProperty;
+using Alembic::Abc::ICompoundProperty;
+using Alembic::Abc::IObject;
+using Alembic::Abc::IScalarProperty;
+using Alembic::Abc::ISampleSelector;
+using Alembic::AbcCoreAbstract::ArraySampleKey;
+using Alembic::AbcCoreAbstract::ArraySamplePtr;
+using Alembic::AbcCoreAbstract::DataType;
+using Alembic::AbcCoreAbstract::PropertyHeader;
+using Alembic::AbcCoreAbstract::TimeSamplingPtr;
+using Alembic::AbcGeom::ICurves;
+using Alembic::AbcGeom::ICurvesSchema;
+using Alembic::AbcGeom::IPolyMesh;
+using Alembic::AbcGeom::IPolyMeshSchema;
+using Alembic::AbcGeom::ISubD;
+using Alembic::AbcGeom::ISubDSchema;
+using Alembic::AbcGeom::IXform;
+using Alembic::AbcGeom::IXformSchema;
+using Alembic::AbcGeom::ObjectHeader;
+using Alembic::AbcGeom::XformSample;
+
+ArraySampleCache::ArraySampleCache(size_t maxBytes)
+    : maxBytes_(maxBytes),
+      bytesStored_(0),
+      bytesRead_(0),
+      hits_(0),
+      misses_(0) {}
+
+void ArraySampleCache::read(const IArrayProperty& prop,
+                            const ISampleSelector& ss) {
+  ArraySampleKey key;
+  bool hasKey = prop.getKey(key, ss);
+  if (hasKey && samples_.count(key)) {
+    hits_++;
+    return;
+  }
+
+  ArraySamplePtr sample;
+  prop.get(sample, ss);
+  misses_++;
+  if (!sample) return;
+
+  size_t bytes = sample->getSize() * sample->getDataType().getNumBytes();
+  bytesRead_ += bytes;
+  if (hasKey && bytesStored_ + bytes <= maxBytes_) {
+    samples_[key] = sample;
+    bytesStored_ += bytes;
+  }
+}
+
+namespace {
+
+size_t readArrayProperty(const IArrayProperty& prop, ArraySampleCache* cache,
+                         size_t maxSamples) {
+  if (!prop.valid()) return 0;
+
+  TimeSamplingPtr timeSampling = prop.getTimeSampling();
+  size_t count = std::min(prop.getNumSamples(), maxSamples);
+  for (size_t i = 0; i < count; i++) {
+    cache->read(prop, ISampleSelector(timeSampling->getSampleTime(i)));
+  }
+  return count;
+}
+
+template <class GEOMPARAM>
+size_t readGeomParam(const GEOMPARAM& param, ArraySampleCache* cache,
+                     size_t maxSamples) {
+  if (!param.valid()) return 0;
+
+  size_t count = readArrayProperty(param.getValueProperty(), cache, maxSamples);
+  if (param.isIndexed()) {
+    count += readArrayProperty(param.getIndexProperty(), cache, maxSamples);
+  }
+  return count;
+}
+
+size_t readPolyMesh(const IObject& node, ArraySampleCache* cache,
+                    size_t maxSamples) {
+  const IPolyMesh mesh(node.getParent(), node.getHeader().getName());
+  const IPolyMeshSchema& schema = mesh.getSchema();
+
+  return readArrayProperty(schema.getPositionsProperty(), cache, maxSamples) +
+         readArrayProperty(schema.getFaceIndicesProperty(), cache,
+                           maxSamples) +
+         readArrayProperty(schema.getFaceCountsProperty(), cache,
+                           maxSamples) +
+         readGeomParam(schema.getNormalsParam(), cache, maxSamples) +
+         readGeomParam(schema.getUVsParam(), cache, maxSamples);
+}
+
+size_t readSubD(const IObject& node, ArraySampleCache* cache,
+                size_t maxSamples) {
+  const ISubD mesh(node.getParent(), node.getHeader().getName());
+  const ISubDSchema& schema = mesh.getSchema();
+
+  return readArrayProperty(schema.getPositionsProperty(), cache, maxSamples) +
+         readArrayProperty(schema.getFaceIndicesProperty(), cache,
+                           maxSamples) +
+         readArrayProperty(schema.getFaceCountsProperty(), cache,
+                           maxSamples) +
+         readGeomParam(schema.getUVsParam(), cache, maxSamples);
+}
+
+size_t readCurves(const IObject& node, ArraySampleCache* cache,
+                  size_t maxSamples) {
+  const ICurves curves(node.getParent(), node.getHeader().getName());
+  const ICurvesSchema& schema = curves.getSchema();
+
+  return readArrayProperty(schema.getPositionsProperty(), cache, maxSamples) +
+         readArrayProperty(schema.getNumVerticesProperty(), cache,
+                           maxSamples) +
+         readGeomParam(schema.getNormalsParam(), cache, maxSamples) +
+         readGeomParam(schema.getUVsParam(), cache, maxSamples);
+}
+
+// Xform samples are scalar, so they bypass the array sample cache.
+size_t readXform(const IObject& node, size_t maxSamples) {
+  const IXform xform(node.getParent(), node.getHeader().getName());
+  const IXformSchema& schema = xform.getSchema();
+
+  TimeSamplingPtr timeSampling = schema.getTimeSampling();
+  size_t count = std::min(schema.getNumSamples(), maxSamples);
+  for (size_t i = 0; i < count; i++) {
+    XformSample sample;
+    schema.get(sample, ISampleSelector(timeSampling->getSampleTime(i)));
+    for (size_t op = 0; op < sample.getNumOps(); op++) {
+      sample.getOp(op).getNumChannels();
+    }
+  }
+  return count;
+}
+
+}  // namespace
+
+size_t readSamples(const IObject& node, ArraySampleCache* cache,
+                   size_t maxSamplesPerProperty) {
+  const ObjectHeader& header = node.getHeader();
+
+  size_t count = 0;
+  if (IPolyMesh::matches(header)) {
+    count += readPolyMesh(node, cache, maxSamplesPerProperty);
+  } else if (ISubD::matches(header)) {
+    count += readSubD(node, cache, maxSamplesPerProperty);
+  } else if (ICurves::matches(header)) {
+    count += readCurves(node, cache, maxSamplesPerProperty);
+  } else if (IXform::matches(header)) {
+    count += readXform(node, maxSamplesPerProperty);
+  }
+
+  const size_t childCount = node.getNumChildren();
+  for (size_t i = 0; i < childCount; i++) {
+    count += readSamples(node.getChild(i), cache, maxSamplesPerProperty);
+  }
+  return count;
+}
+
+namespace {
+
+// Scalar samples are written into caller storage, which has to hold
+// constructed strings for the string PODs.
+void readScalarValue(const ICompoundProperty& parent,
+                     const PropertyHeader& header) {
+  IScalarProperty prop(parent, header.getName());
+  if (prop.getNumSamples() == 0) return;
+
+  // A zero extent or unknown POD would leave nothing to write into.
+  const DataType& dataType = header.getDataType();
+  if (dataType.getExtent() == 0 || dataType.getNumBytes() == 0) return;
+
+  if (dataType.getPod() == Alembic::Util::kStringPOD) {
+    std::vector<std::string> value(dataType.getExtent());
+    prop.get(value.data());
+  } else if (dataType.getPod() == Alembic::Util::kWstringPOD) {
+    std::vector<std::wstring> value(dataType.getExtent());
+    prop.get(value.data());
+  } else {
+    std::vector<char> value(dataType.getNumBytes());
+    prop.get(value.data());
+  }
+}
+
+}  // namespace
+
+size_t readPropertyValues(const ICompoundProperty& parent, size_t* budget) {
+  size_t count = 0;
+  const size_t propertyCount = parent.getNumProperties();
+  for (size_t p = 0; p < propertyCount && *budget > 0; p++) {
+    const PropertyHeader& header = parent.getPropertyHeader(p);
+    (*budget)--;
+
+    if (header.isCompound()) {
+      count += readPropertyValues(ICompoundProperty(parent, header.getName()),
+                                  budget);
+    } else if (header.isScalar()) {
+      readScalarValue(parent, header);
+      count++;
+    } else if (header.isArray()) {
+      IArrayProperty prop(parent, header.getName());
+      if (prop.getNumSamples() > 0) {
+        ArraySamplePtr sample;
+        prop.get(sample);
+      }
+      count++;
+    }
+  }
+  return count;
+}
@@ -0,0 +1,62 @@
+// Reads the per-frame geometry samples and property values of an Alembic
+// archive.
+
+#ifndef ALEMBIC_SAMPLES_H_
+#define ALEMBIC_SAMPLES_H_
+
+#include <stddef.h>
+
+#include <map>
+
+#include <Alembic/Abc/All.h>
+
+// Array samples keyed by their digest, shared by every property of an
+// archive. Ogawa archives ignore the library's ReadArraySampleCache, so the
+// lookup is done here: identical samples (static topology, repeated frames)
+// are only read once.
+//
+// Once maxBytes of samples are held, new samples are read but not stored.
+class ArraySampleCache {
+ public:
+  explicit ArraySampleCache(size_t maxBytes);
+
+  // Read the sample of prop selected by ss, from the cache if possible.
+  void read(const Alembic::Abc::IArrayProperty& prop,
+            const Alembic::Abc::ISampleSelector& ss);
+
+  size_t hits() const { return hits_; }
+  size_t misses() const { return misses_; }
+  size_t bytesRead() const { return bytesRead_; }
+
+ private:
+  typedef std::map<Alembic::AbcCoreAbstract::ArraySampleKey,
+                   Alembic::AbcCoreAbstract::ArraySamplePtr>
+      SampleMap;
+
+  size_t maxBytes_;
+  size_t bytesStored_;
+  size_t bytesRead_;
+  size_t hits_;
+  size_t misses_;
+  SampleMap samples_;
+};
+
+// Read every sample of the positions, normals, UVs, face indices and counts
+// of meshes, subds and curves, and of the xform ops, below node. Samples are
+// selected by time through each property's time sampling. At most
+// maxSamplesPerProperty samples are read per property.
+//
+// Return the number of samples read.
+size_t readSamples(const Alembic::Abc::IObject& node, ArraySampleCache* cache,
+                   size_t maxSamplesPerProperty);
+
+// Read the first sample of every scalar and array property below parent,
+// recursing into compound properties, such as the parameters of a material
+// shader. Each property visited consumes one unit of *budget, and reading
+// stops when it reaches zero.
+//
+// Return the number of property values read.
+size_t readPropertyValues(const Alembic::Abc::ICompoundProperty& parent,
+                          size_t* budget);
+
+#endif  // ALEMBIC_SAMPLES_H_
@@ -0,0 +1,64 @@
+// Per-frame sample reading benchmark for Alembic archives.
+//
+// Reads every sample of every geometry and xform property (see
+// alembic_samples.h) with one array sample cache per archive, and reports
+// samples/sec, MB/s and the cache hit rate.
+//
+// Usage: alembic_samples_benchmark [-c cache_mb] file.abc...
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <exception>
+
+#include <Alembic/AbcCoreFactory/All.h>
+
+#include "alembic_samples.h"
+#include "bench_utils.h"
+
+using Alembic::AbcCoreFactory::IFactory;
+using Alembic::Abc::IArchive;
+
+int main(int argc, char** argv) {
+  size_t cacheBytes = 256 << 20;
+  int opt;
+  while ((opt = getopt(argc, argv, "c:")) != -1) {
+    switch (opt) {
+      case 'c':
+        cacheBytes = strtoul(optarg, NULL, 10) << 20;
+        break;
+      default:
+        fprintf(stderr, "usage: %s [-c cache_mb] file.abc...\n", argv[0]);
+        return 1;
+    }
+  }
+
+  printf("%-40s %10s %12s %10s %10s\n", "file", "samples", "samples/s",
+         "MB/s", "hit rate");
+  for (int i = optind; i < argc; i++) {
+    try {
+      IFactory factory;
+      IArchive archive = factory.getArchive(argv[i]);
+      if (!archive.valid()) {
+        fprintf(stderr, "%s: not a valid archive\n", argv[i]);
+        continue;
+      }
+
+      ArraySampleCache cache(cacheBytes);
+      double start = bench_now();
+      size_t samples = readSamples(archive.getTop(), &cache, (size_t)-1);
+      double seconds = bench_now() - start;
+
+      size_t lookups = cache.hits() + cache.misses();
+      printf("%-40s %10zu %12.0f %10.1f %9.1f%%\n", argv[i], samples,
+             seconds > 0 ? samples / seconds : 0,
+             bench_mb_per_sec(cache.bytesRead(), seconds),
+             lookups ? 100.0 * cache.hits() / lookups : 0);
+    } catch (const std::exception& e) {
+      fprintf(stderr, "%s: %s\n", argv[i], e.what());
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,114 @@
+// Multi-stream concurrent read benchmark for Ogawa Alembic archives.
+//
+// For each stream count n from 1 to N, the archive is opened with
+// IFactory::setOgawaNumStreams(n) and the top-level subtrees of getTop() are
+// shared out to n threads, each reading every sample below its subtrees (see
+// alembic_samples.h) with its own array sample cache. Reports the wall time
+// and the speedup over a single stream.
+//
+// Usage: alembic_streams_benchmark [-n max_streams] file.abc...
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <exception>
+#include <thread>
+#include <vector>
+
+#include <Alembic/AbcCoreFactory/All.h>
+
+#include "alembic_samples.h"
+#include "bench_utils.h"
+
+using Alembic::Abc::IArchive;
+using Alembic::Abc::IObject;
+using Alembic::AbcCoreFactory::IFactory;
+
+namespace {
+
+const size_t kCacheBytesPerThread = 64 << 20;
+
+// Return the number of samples read.
+size_t readConcurrently(const char* file, int streams) {
+  IFactory factory;
+  factory.setOgawaNumStreams(streams);
+  IArchive archive = factory.getArchive(file);
+  if (!archive.valid()) return 0;
+
+  IObject top = archive.getTop();
+  const size_t childCount = top.getNumChildren();
+
+  std::atomic<size_t> next(0);
+  std::vector<size_t> samples(streams);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < streams; t++) {
+    threads.emplace_back([&, t]() {
+      ArraySampleCache cache(kCacheBytesPerThread);
+      for (size_t i = next++; i < childCount; i = next++) {
+        try {
+          samples[t] += readSamples(top.getChild(i), &cache, (size_t)-1);
+        } catch (const std::exception& e) {
+          fprintf(stderr, "%s: child %zu: %s\n", file, i, e.what());
+        }
+      }
+    });
+  }
+
+  size_t total = 0;
+  for (int t = 0; t < streams; t++) {
+    threads[t].join();
+    total += samples[t];
+  }
+  return total;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int maxStreams = std::thread::hardware_concurrency();
+  int opt;
+  while ((opt = getopt(argc, argv, "n:")) != -1) {
+    switch (opt) {
+      case 'n':
+        maxStreams = atoi(optarg);
+        break;
+      default:
+        fprintf(stderr, "usage: %s [-n max_streams] file.abc...\n", argv[0]);
+        return 1;
+    }
+  }
+  if (maxStreams < 1) maxStreams = 1;
+
+  // Read every file once, untimed, so that the 1-stream baseline does not run
+  // against a cold page cache. Files that fail are reported here.
+  for (int i = optind; i < argc; i++) {
+    try {
+      readConcurrently(argv[i], 1);
+    } catch (const std::exception& e) {
+      fprintf(stderr, "%s: %s\n", argv[i], e.what());
+    }
+  }
+
+  printf("%-8s %10s %12s %10s\n", "streams", "samples", "seconds", "speedup");
+  double baseline = 0;
+  for (int streams = 1; streams <= maxStreams; streams++) {
+    size_t samples = 0;
+    double start = bench_now();
+    for (int i = optind; i < argc; i++) {
+      try {
+        samples += readConcurrently(argv[i], streams);
+      } catch (const std::exception& e) {
+        fprintf(stderr, "%s: %s\n", argv[i], e.what());
+      }
+    }
+    double seconds = bench_now() - start;
+    if (streams == 1) baseline = seconds;
+
+    printf("%-8d %10zu %12.3f %9.2fx\n", streams, samples, seconds,
+           seconds > 0 ? baseline / seconds : 0);
+  }
+
+  return 0;
+}
@@ -0,0 +1,54 @@
+#include "bench_utils.h"
+
+#include <err.h>
+#include <stdio.h>
+
+#include <chrono>
+
+double bench_now(void) {
+  return std::chrono::duration<double>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+int bench_read_file(const char *pathname, std::string *out) {
+  FILE *f = fopen(pathname, "rb");
+  if (f == nullptr) {
+    warn("fopen(\"%s\")", pathname);
+    return -1;
+  }
+
+  out->clear();
+  char buf[1 << 16];
+  size_t nbytes;
+  while ((nbytes = fread(buf, 1, sizeof(buf), f)) > 0) {
+    out->append(buf, nbytes);
+  }
+
+  int ret = 0;
+  if (ferror(f)) {
+    warn("fread(\"%s\")", pathname);
+    ret = -1;
+  }
+
+  fclose(f);
+  return ret;
+}
+
+double bench_mb_per_sec(double bytes, double seconds) {
+  if (seconds <= 0) {
+    return 0;
+  }
+  return bytes / (1024.0 * 1024.0) / seconds;
+}
+
+const char *bench_exr_compression_name(int compression) {
+  // Indexed by OpenEXR's Compression enum, which starts at NO_COMPRESSION = 0.
+  static const char *const kNames[] = {"none",  "rle", "zips", "zip",  "piz",
+                                       "pxr24", "b44", "b44a", "dwaa", "dwab"};
+  if (compression < 0 ||
+      compression >= (int)(sizeof(kNames) / sizeof(kNames[0]))) {
+    return "other";
+  }
+  return kNames[compression];
+}
@@ -0,0 +1,26 @@
+// Helper functions for the *_benchmark.cc drivers.
+
+#ifndef BENCH_UTILS_H_
+#define BENCH_UTILS_H_
+
+#include <stddef.h>
+
+#include <string>
+
+// Return a monotonic timestamp in seconds.
+double bench_now(void);
+
+// Read the whole file at pathname into *out.
+//
+// Return 0 on success, -1 otherwise.
+int bench_read_file(const char *pathname, std::string *out);
+
+// Return bytes / seconds in MB/s, or 0 if no time was measured.
+double bench_mb_per_sec(double bytes, double seconds);
+
+// Return the short name of an OpenEXR Compression value, such as "zip" for
+// ZIP_COMPRESSION, or "other" if it is out of range. These names are part of
+// the OpenEXR corpus file names.
+const char *bench_exr_compression_name(int compression);
+
+#endif  // BENCH_UTILS_H_
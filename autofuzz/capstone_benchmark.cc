@@ -0,0 +1,196 @@
+// Disassembly throughput benchmark over the capstone_fuzz platform table.
+//
+// Every platform decodes the same input with CS_OPT_DETAIL off and on, and
+// CS_OPT_SKIPDATA off and on. Without skipdata decoding stops at the first
+// invalid instruction, so the share of the input covered is reported next to
+// MB/s (of covered bytes) and instructions/sec.
+//
+// With -s, every platform instead decodes and prints the input once per
+// CS_OPT_SYNTAX value that applies to its architecture (detail off, skipdata
+// on). Capstone always formats mnemonic and op_str unless built in diet mode,
+// in which case the numbers are for decoding only; the report says which.
+//
+// The input is the concatenation of the files given, or 1 MB of
+// deterministic pseudo-random bytes.
+//
+// Usage: capstone_benchmark [-s] [-r repeats] [file...]
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <string>
+
+#include "bench_utils.h"
+#include "capstone/capstone.h"
+#include "capstone_platforms.h"
+
+namespace {
+
+struct Syntax {
+  cs_opt_value value;  // 0 leaves the architecture's default.
+  const char *name;
+};
+
+const Syntax kSyntaxes[] = {
+    {(cs_opt_value)0, "default"},
+    {CS_OPT_SYNTAX_INTEL, "intel"},
+    {CS_OPT_SYNTAX_ATT, "att"},
+#if CS_API_MAJOR >= 4
+    {CS_OPT_SYNTAX_MASM, "masm"},
+#endif
+    {CS_OPT_SYNTAX_NOREGNAME, "noregname"},
+};
+
+// Most architectures accept any CS_OPT_SYNTAX value and ignore it, which
+// would only repeat the default row. Only x86 has alternative syntaxes, and
+// only ARM and PowerPC print registers differently with noregname.
+bool syntaxApplies(cs_arch arch, cs_opt_value syntax) {
+  switch (syntax) {
+    case 0:
+      return true;
+    case CS_OPT_SYNTAX_NOREGNAME:
+      return arch == CS_ARCH_ARM || arch == CS_ARCH_PPC;
+    default:
+      return arch == CS_ARCH_X86;
+  }
+}
+
+struct Result {
+  size_t insns = 0;
+  size_t bytes = 0;
+  double seconds = 0;
+};
+
+std::string randomInput(size_t size) {
+  std::string input(size, '\0');
+  uint32_t state = 0x12345678;
+  for (size_t i = 0; i < size; i++) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    input[i] = (char)state;
+  }
+  return input;
+}
+
+// Decodes input with the given options, the way a scanner walks a section.
+//
+// Return false if the platform does not accept the options.
+bool disassemble(const platform &p, bool detail, bool skipdata,
+                 cs_opt_value syntax, const std::string &input, int repeats,
+                 Result *result) {
+  csh handle;
+  if (cs_open(p.arch, p.mode, &handle) != CS_ERR_OK) {
+    return false;
+  }
+  if (syntax != 0 && cs_option(handle, CS_OPT_SYNTAX, syntax) != CS_ERR_OK) {
+    cs_close(&handle);
+    return false;
+  }
+  cs_option(handle, CS_OPT_DETAIL, detail ? CS_OPT_ON : CS_OPT_OFF);
+  cs_option(handle, CS_OPT_SKIPDATA, skipdata ? CS_OPT_ON : CS_OPT_OFF);
+
+  cs_insn *insn = cs_malloc(handle);
+  double start = bench_now();
+  for (int r = 0; r < repeats; r++) {
+    const uint8_t *code = (const uint8_t *)input.data();
+    size_t size = input.size();
+    uint64_t address = 0x1000;
+    while (cs_disasm_iter(handle, &code, &size, &address, insn)) {
+      result->insns++;
+    }
+    result->bytes += input.size() - size;
+  }
+  result->seconds = bench_now() - start;
+
+  cs_free(insn, 1);
+  cs_close(&handle);
+  return true;
+}
+
+void printResult(const platform &p, const char *options,
+                 const std::string &input, int repeats,
+                 const Result &result) {
+  printf("%-32s %-20s %10zu %8.1f%% %10.1f %12.0f\n", p.comment.c_str(),
+         options, result.insns / repeats,
+         100.0 * result.bytes / ((double)input.size() * repeats),
+         bench_mb_per_sec(result.bytes, result.seconds),
+         result.seconds > 0 ? result.insns / result.seconds : 0);
+}
+
+void benchmarkOptions(const std::string &input, int repeats) {
+  for (int p = 0; p < platforms_len; p++) {
+    for (int skipdata = 0; skipdata < 2; skipdata++) {
+      for (int detail = 0; detail < 2; detail++) {
+        Result result;
+        if (!disassemble(platforms[p], detail, skipdata, (cs_opt_value)0,
+                         input, repeats, &result)) {
+          continue;
+        }
+
+        std::string options = std::string("detail=") +
+                              (detail ? "on" : "off") + " skipdata=" +
+                              (skipdata ? "on" : "off");
+        printResult(platforms[p], options.c_str(), input, repeats, result);
+      }
+    }
+  }
+}
+
+void benchmarkSyntaxes(const std::string &input, int repeats) {
+  printf("printing: %s\n", cs_support(CS_SUPPORT_DIET)
+                               ? "off (diet build, decode only)"
+                               : "on (decode + print)");
+  for (int p = 0; p < platforms_len; p++) {
+    for (const Syntax &syntax : kSyntaxes) {
+      if (!syntaxApplies(platforms[p].arch, syntax.value)) continue;
+      Result result;
+      if (disassemble(platforms[p], false, true, syntax.value, input, repeats,
+                      &result)) {
+        printResult(platforms[p], syntax.name, input, repeats, result);
+      }
+    }
+  }
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  bool syntaxes = false;
+  int repeats = 3;
+  int opt;
+  while ((opt = getopt(argc, argv, "sr:")) != -1) {
+    switch (opt) {
+      case 's':
+        syntaxes = true;
+        break;
+      case 'r':
+        repeats = atoi(optarg);
+        break;
+      default:
+        fprintf(stderr, "usage: %s [-s] [-r repeats] [file...]\n", argv[0]);
+        return 1;
+    }
+  }
+  if (repeats < 1) repeats = 1;
+
+  std::string input;
+  for (int i = optind; i < argc; i++) {
+    std::string data;
+    if (bench_read_file(argv[i], &data) == 0) input += data;
+  }
+  if (input.empty()) input = randomInput(1 << 20);
+
+  printf("%-32s %-20s %10s %9s %10s %12s\n", "platform", "options", "insns",
+         "covered", "MB/s", "insns/s");
+  if (syntaxes) {
+    benchmarkSyntaxes(input, repeats);
+  } else {
+    benchmarkOptions(input, repeats);
+  }
+
+  return 0;
+}
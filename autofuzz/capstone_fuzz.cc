@@ -1,45 +1,8 @@
 #include <inttypes.h>
 #include <stdio.h>
 
-#include <string>
-
 #include "capstone/capstone.h"
-
-struct platform {
-  cs_arch arch;
-  cs_mode mode;
-  std::string comment;
-};
-
-// Note: changing this struct will modify reproducibility of previous crashes.
-// Taken from test_detail.c.
-struct platform platforms[] = {
-    {CS_ARCH_X86, CS_MODE_32, "X86 32"},
-    {CS_ARCH_X86, CS_MODE_64, "X86 64"},
-    {CS_ARCH_ARM, CS_MODE_ARM, "ARM"},
-    {CS_ARCH_ARM, CS_MODE_THUMB, "THUMB-2"},
-    {CS_ARCH_ARM, CS_MODE_ARM, "ARM: Cortex-A15 + NEON"},
-    {CS_ARCH_ARM, CS_MODE_THUMB, "THUMB"},
-    {CS_ARCH_ARM, (cs_mode)(CS_MODE_THUMB + CS_MODE_MCLASS), "Thumb-MClass"},
-    {CS_ARCH_ARM, (cs_mode)(CS_MODE_ARM + CS_MODE_V8), "Arm-V8"},
-    {CS_ARCH_MIPS, (cs_mode)(CS_MODE_MIPS32 + CS_MODE_BIG_ENDIAN),
-     "MIPS-32 (Big-endian)"},
-    {CS_ARCH_MIPS, (cs_mode)(CS_MODE_MIPS64 + CS_MODE_LITTLE_ENDIAN),
-     "MIPS-64-EL (Little-endian)"},
-    {CS_ARCH_MIPS,
-     (cs_mode)(CS_MODE_MIPS32R6 + CS_MODE_MICRO + CS_MODE_BIG_ENDIAN),
-     "MIPS-32R6 | Micro (Big-endian)"},
-    {CS_ARCH_MIPS, (cs_mode)(CS_MODE_MIPS32R6 + CS_MODE_BIG_ENDIAN),
-     "MIPS-32R6 (Big-endian)"},
-    {CS_ARCH_ARM64, CS_MODE_ARM, "ARM-64"},
-    {CS_ARCH_PPC, CS_MODE_BIG_ENDIAN, "PPC-64"},
-    {CS_ARCH_SPARC, CS_MODE_BIG_ENDIAN, "Sparc"},
-    {CS_ARCH_SPARC, (cs_mode)(CS_MODE_BIG_ENDIAN + CS_MODE_V9), "SparcV9"},
-    {CS_ARCH_SYSZ, (cs_mode)0, "SystemZ"},
-    {CS_ARCH_XCORE, (cs_mode)0, "XCore"},
-};
-
-int platforms_len = sizeof(platforms) / sizeof(platforms[0]);
+#include "capstone_platforms.h"
 
 extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t data_len) {
   if (data_len < 3) {
@@ -52,6 +15,12 @@ extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t data_len) {
 
   int selected_platform = (int)data[0] % platforms_len;
 
+  // The spare bits of the platform byte select the options. Values below
+  // platforms_len keep the original behavior (detail on, skipdata off).
+  int options = (int)data[0] / platforms_len;
+  bool detail = (options & 1) == 0;
+  bool skipdata = (options & 2) != 0;
+
   const uint8_t *buf_ptr = data + 1;
   size_t buf_ptr_size = data_len - 1;
 
@@ -67,7 +36,10 @@ extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t data_len) {
     return 0;
   }
 
-  cs_option(handle, CS_OPT_DETAIL, CS_OPT_ON);
+  cs_option(handle, CS_OPT_DETAIL, detail ? CS_OPT_ON : CS_OPT_OFF);
+  if (skipdata) {
+    cs_option(handle, CS_OPT_SKIPDATA, CS_OPT_ON);
+  }
 
   uint64_t address = 0x1000;
   size_t count =
@@ -88,6 +60,9 @@ extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t data_len) {
            i->mnemonic, i->op_str, i->id, cs_insn_name(handle, i->id));
 
     cs_detail *detail = i->detail;
+    if (detail == NULL) {
+      continue;
+    }
 
     if (detail->regs_read_count > 0) {
       printf("Implicit registers read: \n");
@@ -0,0 +1,31 @@
+#include "capstone_platforms.h"
+
+// Note: changing this struct will modify reproducibility of previous crashes.
+// Taken from test_detail.c.
+struct platform platforms[] = {
+    {CS_ARCH_X86, CS_MODE_32, "X86 32"},
+    {CS_ARCH_X86, CS_MODE_64, "X86 64"},
+    {CS_ARCH_ARM, CS_MODE_ARM, "ARM"},
+    {CS_ARCH_ARM, CS_MODE_THUMB, "THUMB-2"},
+    {CS_ARCH_ARM, CS_MODE_ARM, "ARM: Cortex-A15 + NEON"},
+    {CS_ARCH_ARM, CS_MODE_THUMB, "THUMB"},
+    {CS_ARCH_ARM, (cs_mode)(CS_MODE_THUMB + CS_MODE_MCLASS), "Thumb-MClass"},
+    {CS_ARCH_ARM, (cs_mode)(CS_MODE_ARM + CS_MODE_V8), "Arm-V8"},
+    {CS_ARCH_MIPS, (cs_mode)(CS_MODE_MIPS32 + CS_MODE_BIG_ENDIAN),
+     "MIPS-32 (Big-endian)"},
+    {CS_ARCH_MIPS, (cs_mode)(CS_MODE_MIPS64 + CS_MODE_LITTLE_ENDIAN),
+     "MIPS-64-EL (Little-endian)"},
+    {CS_ARCH_MIPS,
+     (cs_mode)(CS_MODE_MIPS32R6 + CS_MODE_MICRO + CS_MODE_BIG_ENDIAN),
+     "MIPS-32R6 | Micro (Big-endian)"},
+    {CS_ARCH_MIPS, (cs_mode)(CS_MODE_MIPS32R6 + CS_MODE_BIG_ENDIAN),
+     "MIPS-32R6 (Big-endian)"},
+    {CS_ARCH_ARM64, CS_MODE_ARM, "ARM-64"},
+    {CS_ARCH_PPC, CS_MODE_BIG_ENDIAN, "PPC-64"},
+    {CS_ARCH_SPARC, CS_MODE_BIG_ENDIAN, "Sparc"},
+    {CS_ARCH_SPARC, (cs_mode)(CS_MODE_BIG_ENDIAN + CS_MODE_V9), "SparcV9"},
+    {CS_ARCH_SYSZ, (cs_mode)0, "SystemZ"},
+    {CS_ARCH_XCORE, (cs_mode)0, "XCore"},
+};
+
+int platforms_len = sizeof(platforms) / sizeof(platforms[0]);
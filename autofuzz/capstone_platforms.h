@@ -0,0 +1,19 @@
+// Architecture/mode table shared by the capstone fuzz target and benchmarks.
+
+#ifndef CAPSTONE_PLATFORMS_H_
+#define CAPSTONE_PLATFORMS_H_
+
+#include <string>
+
+#include "capstone/capstone.h"
+
+struct platform {
+  cs_arch arch;
+  cs_mode mode;
+  std::string comment;
+};
+
+extern struct platform platforms[];
+extern int platforms_len;
+
+#endif  // CAPSTONE_PLATFORMS_H_
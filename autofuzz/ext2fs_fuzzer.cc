@@ -3,6 +3,10 @@
 #include <unistd.h>
 
 #include "ext2fs/ext2fs.h"
+#include "ext2fs_walk.h"
+
+// Inodes, extents, index blocks and directory entries visited per input.
+static const uint64_t kMaxWalkNodes = 1 << 16;
 
 extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
   static const char* pattern = "/dev/shm/ext2XXXXXX";
@@ -38,6 +42,16 @@ extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
     goto out2;
   }
 
+  // Walk the extent trees and hashed directories, which are where ext4 spends
+  // its time. Mutated images rarely keep valid checksums, so do not let them
+  // stop the walk at the first block.
+  {
+    fs->flags |= EXT2_FLAG_IGNORE_CSUM_ERRORS;
+    uint64_t budget = kMaxWalkNodes;
+    WalkStats stats;
+    walkFilesystem(fs, &budget, &stats);
+  }
+
 out2:
   ext2fs_close(fs);
 
@@ -0,0 +1,230 @@
+// Parallel inode table scan benchmark for ext2fs.
+//
+// ext2fs_fuzzer opens an image and reads the inode and block bitmaps, which
+// libext2fs does one block group after the other. This driver times that
+// serial path, then scans the inode tables with 1, 2, 4, ... threads. Block
+// groups are handed out to the threads one at a time, and every thread opens
+// its own ext2_filsys, and so its own io channel, on the same image: a
+// filesystem handle is not safe to share between threads.
+//
+// With -m the image is first copied to /dev/shm, as ext2fs_fuzzer does with
+// its input, so that the scan measures libext2fs rather than the disk.
+// Images with the 64bit feature are opened with EXT2_FLAG_64BITS.
+//
+// Usage: ext2fs_scan_benchmark [-m] [-r repeats] [-t max_threads] image
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench_utils.h"
+#include "ext2fs/ext2fs.h"
+
+namespace {
+
+struct ScanResult {
+  uint64_t inodes = 0;
+  uint64_t used = 0;
+  bool failed = false;
+};
+
+errcode_t openImage(const char* fname, ext2_filsys* fs) {
+  return ext2fs_open(fname, EXT2_FLAG_64BITS, 0, 0, unix_io_manager, fs);
+}
+
+// Scans the inode table of one block group. The scan would carry on into the
+// next group, so stop once the last inode of this one has been counted,
+// before anything of the next group's inode table is read. The ino > last
+// check only catches groups whose unused tail the scan skips.
+errcode_t scanGroup(ext2_filsys fs, ext2_inode_scan scan, dgrp_t group,
+                    std::vector<char>* buf, ScanResult* result) {
+  errcode_t retval = ext2fs_inode_scan_goto_blockgroup(scan, group);
+  if (retval != 0) return retval;
+
+  const ext2_ino_t last =
+      (ext2_ino_t)(group + 1) * fs->super->s_inodes_per_group;
+  struct ext2_inode* inode = (struct ext2_inode*)buf->data();
+  ext2_ino_t ino;
+  while ((retval = ext2fs_get_next_inode_full(scan, &ino, inode,
+                                              buf->size())) == 0) {
+    if (ino == 0 || ino > last) break;
+    result->inodes++;
+    if (inode->i_links_count != 0) result->used++;
+    if (ino == last) break;
+  }
+  return retval == EXT2_ET_BAD_BLOCK_IN_INODE_TABLE ? 0 : retval;
+}
+
+void scanWorker(const char* fname, std::atomic<dgrp_t>* next,
+                ScanResult* result) {
+  ext2_filsys fs;
+  if (openImage(fname, &fs) != 0) {
+    result->failed = true;
+    return;
+  }
+
+  ext2_inode_scan scan;
+  if (ext2fs_open_inode_scan(fs, 0, &scan) != 0) {
+    result->failed = true;
+    ext2fs_close(fs);
+    return;
+  }
+
+  std::vector<char> buf(EXT2_INODE_SIZE(fs->super));
+  for (;;) {
+    dgrp_t group = (*next)++;
+    if (group >= fs->group_desc_count) break;
+    if (scanGroup(fs, scan, group, &buf, result) != 0) {
+      result->failed = true;
+      break;
+    }
+  }
+
+  ext2fs_close_inode_scan(scan);
+  ext2fs_close(fs);
+}
+
+// Returns the seconds taken to scan every group with n threads, including
+// opening the per-thread filesystems.
+double scan(const char* fname, int n, ScanResult* total) {
+  std::atomic<dgrp_t> next(0);
+  std::vector<ScanResult> results(n);
+  std::vector<std::thread> threads;
+
+  double start = bench_now();
+  for (int t = 0; t < n; t++) {
+    threads.emplace_back(scanWorker, fname, &next, &results[t]);
+  }
+  for (int t = 0; t < n; t++) threads[t].join();
+  double seconds = bench_now() - start;
+
+  for (const ScanResult& r : results) {
+    total->inodes += r.inodes;
+    total->used += r.used;
+    total->failed |= r.failed;
+  }
+  return seconds;
+}
+
+// Copies the image to /dev/shm the way ext2fs_fuzzer writes its input.
+// Returns the name of the copy, or an empty string on failure.
+std::string copyToShm(const char* path) {
+  std::string data;
+  if (bench_read_file(path, &data) != 0) return std::string();
+
+  char fname[] = "/dev/shm/ext2XXXXXX";
+  int fd = mkstemp(fname);
+  if (fd < 0) {
+    perror("mkstemp");
+    return std::string();
+  }
+  size_t written = 0;
+  while (written < data.size()) {
+    ssize_t n = write(fd, data.data() + written, data.size() - written);
+    if (n <= 0) {
+      perror(fname);
+      close(fd);
+      unlink(fname);
+      return std::string();
+    }
+    written += n;
+  }
+  close(fd);
+  return fname;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  bool inMemory = false;
+  int repeats = 3;
+  int maxThreads = std::thread::hardware_concurrency();
+  int opt;
+  while ((opt = getopt(argc, argv, "mr:t:")) != -1) {
+    switch (opt) {
+      case 'm':
+        inMemory = true;
+        break;
+      case 'r':
+        repeats = atoi(optarg);
+        break;
+      case 't':
+        maxThreads = atoi(optarg);
+        break;
+      default:
+        optind = argc;
+        break;
+    }
+  }
+  if (optind != argc - 1) {
+    fprintf(stderr, "usage: %s [-m] [-r repeats] [-t max_threads] image\n",
+            argv[0]);
+    return 1;
+  }
+  if (repeats < 1) repeats = 1;
+  if (maxThreads < 1) maxThreads = 1;
+
+  std::string copy;
+  const char* fname = argv[optind];
+  if (inMemory) {
+    copy = copyToShm(fname);
+    if (copy.empty()) return 1;
+    fname = copy.c_str();
+  }
+
+  ext2_filsys fs;
+  errcode_t retval = openImage(fname, &fs);
+  if (retval != 0) {
+    fprintf(stderr, "%s: ext2fs_open failed: %ld\n", argv[optind],
+            (long)retval);
+    if (!copy.empty()) unlink(copy.c_str());
+    return 1;
+  }
+  const dgrp_t groups = fs->group_desc_count;
+  const uint64_t inodeCount = fs->super->s_inodes_count;
+  ext2fs_close(fs);
+
+  // The serial path of ext2fs_fuzzer, for reference.
+  double bitmapSeconds = 0;
+  for (int r = 0; r < repeats; r++) {
+    if (openImage(fname, &fs) != 0) break;
+    double start = bench_now();
+    ext2fs_read_inode_bitmap(fs);
+    ext2fs_read_block_bitmap(fs);
+    bitmapSeconds += bench_now() - start;
+    ext2fs_close(fs);
+  }
+
+  printf("groups: %u, inodes: %llu, bitmaps: %.2f ms\n", (unsigned)groups,
+         (unsigned long long)inodeCount, 1e3 * bitmapSeconds / repeats);
+  printf("%8s %14s %12s %10s\n", "threads", "inodes/sec", "used", "speedup");
+
+  std::vector<int> threadCounts;
+  for (int n = 1; n < maxThreads; n *= 2) threadCounts.push_back(n);
+  threadCounts.push_back(maxThreads);
+
+  double serialRate = 0;
+  for (int n : threadCounts) {
+    ScanResult total;
+    double seconds = 0;
+    for (int r = 0; r < repeats; r++) seconds += scan(fname, n, &total);
+    if (total.failed) fprintf(stderr, "%d threads: scan failed\n", n);
+
+    double rate = seconds > 0 ? total.inodes / seconds : 0;
+    if (n == 1) serialRate = rate;
+    printf("%8d %14.0f %12llu %9.2fx\n", n, rate,
+           (unsigned long long)(total.used / repeats),
+           serialRate > 0 ? rate / serialRate : 0);
+  }
+
+  if (!copy.empty()) unlink(copy.c_str());
+  return 0;
+}
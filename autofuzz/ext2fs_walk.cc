@@ -0,0 +1,213 @@
+#include "ext2fs_walk.h"
+
+#include <vector>
+
+namespace {
+
+// Index levels, the dx root included, that ext4 allows with largedir.
+const int kMaxDxLevels = 3;
+
+// Offset of the dx_root_info in block 0 of a hashed directory: it follows
+// the "." entry and the header of the ".." entry.
+const unsigned int kDxRootInfoOffset = 24;
+
+// Offset of the count/limit header in an interior index block, after the
+// empty directory entry that hides the index from older kernels.
+const unsigned int kDxNodeOffset = 8;
+
+struct DirWalk {
+  ext2_filsys fs;
+  ext2_ino_t ino;
+  struct ext2_inode* inode;
+  uint64_t* budget;
+  WalkStats* stats;
+  // One block per tree level, so that a parent's entries stay valid while its
+  // children are read.
+  std::vector<char> blocks;
+};
+
+errcode_t walkExtents(ext2_filsys fs, ext2_ino_t ino, struct ext2_inode* inode,
+                      uint64_t* budget, WalkStats* stats) {
+  ext2_extent_handle_t handle;
+  errcode_t retval = ext2fs_extent_open2(fs, ino, inode, &handle);
+  if (retval != 0) return retval;
+
+  struct ext2fs_extent extent;
+  int op = EXT2_EXTENT_ROOT;
+  while (*budget > 0) {
+    retval = ext2fs_extent_get(handle, op, &extent);
+    if (retval != 0) break;
+    op = EXT2_EXTENT_NEXT;
+
+    // Index entries are returned again on the way back up; count them once.
+    if (extent.e_flags & EXT2_EXTENT_FLAGS_SECOND_VISIT) continue;
+    (*budget)--;
+    if (extent.e_flags & EXT2_EXTENT_FLAGS_LEAF) {
+      stats->extents++;
+    } else {
+      stats->extentNodes++;
+    }
+  }
+
+  ext2fs_extent_free(handle);
+  return retval == EXT2_ET_EXTENT_NO_NEXT ? 0 : retval;
+}
+
+// Read logical block lblk of the directory into the buffer for depth. Every
+// block read, root, index or leaf, consumes one unit of budget; once it is
+// spent, *block is set to NULL and nothing is read.
+errcode_t readDirBlock(DirWalk* w, blk64_t lblk, int depth, char** block) {
+  *block = NULL;
+  if (*w->budget == 0) return 0;
+  (*w->budget)--;
+
+  blk64_t pblk = 0;
+  errcode_t retval =
+      ext2fs_bmap2(w->fs, w->ino, w->inode, NULL, 0, lblk, NULL, &pblk);
+  if (retval != 0) return retval;
+  if (pblk == 0) return EXT2_ET_DIR_CORRUPTED;
+
+  char* buf = w->blocks.data() + (size_t)depth * w->fs->blocksize;
+  retval = ext2fs_read_dir_block4(w->fs, pblk, buf, 0, w->ino);
+  if (retval == 0) *block = buf;
+  return retval;
+}
+
+void countLeafEntries(DirWalk* w, char* block) {
+  unsigned int offset = 0;
+  while (*w->budget > 0 && offset + 8 <= w->fs->blocksize) {
+    struct ext2_dir_entry* dirent = (struct ext2_dir_entry*)(block + offset);
+    unsigned int recLen;
+    if (ext2fs_get_rec_len(w->fs, dirent, &recLen) != 0 || recLen < 8 ||
+        recLen % 4 != 0 || offset + recLen > w->fs->blocksize) {
+      break;
+    }
+    if (dirent->inode != 0) {
+      w->stats->dirEntries++;
+      (*w->budget)--;
+    }
+    offset += recLen;
+  }
+}
+
+// Visit the count/limit header and entries at offset in the index block at
+// depth, and every block they point to. levelsBelow is the number of index
+// levels between this block and the leaves.
+errcode_t walkDxEntries(DirWalk* w, char* block, unsigned int offset,
+                        int depth, int levelsBelow) {
+  w->stats->htreeNodes++;
+
+  const struct ext2_dx_countlimit* countLimit =
+      (const struct ext2_dx_countlimit*)(block + offset);
+  unsigned int count = ext2fs_le16_to_cpu(countLimit->count);
+  unsigned int limit = ext2fs_le16_to_cpu(countLimit->limit);
+  if (count == 0 || count > limit ||
+      offset + count * sizeof(struct ext2_dx_entry) > w->fs->blocksize) {
+    return EXT2_ET_DIR_CORRUPTED;
+  }
+
+  // The count/limit header takes the place of the first entry's hash.
+  const struct ext2_dx_entry* entries =
+      (const struct ext2_dx_entry*)(block + offset);
+  for (unsigned int i = 0; i < count && *w->budget > 0; i++) {
+    blk64_t lblk = ext2fs_le32_to_cpu(entries[i].block) & 0x0fffffff;
+    char* child;
+    errcode_t retval = readDirBlock(w, lblk, depth + 1, &child);
+    if (retval != 0) return retval;
+    if (child == NULL) break;
+
+    if (levelsBelow > 0) {
+      retval =
+          walkDxEntries(w, child, kDxNodeOffset, depth + 1, levelsBelow - 1);
+      if (retval != 0) return retval;
+    } else {
+      countLeafEntries(w, child);
+    }
+  }
+  return 0;
+}
+
+errcode_t walkHtree(DirWalk* w) {
+  char* root;
+  errcode_t retval = readDirBlock(w, 0, 0, &root);
+  if (retval != 0 || root == NULL) return retval;
+
+  const struct ext2_dx_root_info* info =
+      (const struct ext2_dx_root_info*)(root + kDxRootInfoOffset);
+  unsigned int offset = kDxRootInfoOffset + info->info_length;
+  if (info->reserved_zero != 0 || info->info_length < sizeof(*info) ||
+      info->indirect_levels >= kMaxDxLevels ||
+      offset + sizeof(struct ext2_dx_countlimit) > w->fs->blocksize) {
+    return EXT2_ET_DIR_CORRUPTED;
+  }
+
+  w->stats->htreeDirs++;
+  return walkDxEntries(w, root, offset, 0, info->indirect_levels);
+}
+
+// Called with DIRENT_FLAG_INCLUDE_EMPTY, so that every block, even one with
+// only deleted entries, is seen at offset 0 and consumes one unit of budget,
+// as readDirBlock() does for hashed directories.
+int countDirEntry(ext2_ino_t, int, struct ext2_dir_entry* dirent, int offset,
+                  int, char*, void* priv) {
+  DirWalk* w = (DirWalk*)priv;
+  if (offset == 0) (*w->budget)--;
+  if (dirent->inode != 0 && *w->budget > 0) {
+    w->stats->dirEntries++;
+    (*w->budget)--;
+  }
+  return *w->budget > 0 ? 0 : DIRENT_ABORT;
+}
+
+errcode_t walkDirectory(ext2_filsys fs, ext2_ino_t ino,
+                        struct ext2_inode* inode, uint64_t* budget,
+                        WalkStats* stats) {
+  DirWalk w;
+  w.fs = fs;
+  w.ino = ino;
+  w.inode = inode;
+  w.budget = budget;
+  w.stats = stats;
+  stats->dirs++;
+
+  if ((inode->i_flags & EXT2_INDEX_FL) &&
+      ext2fs_has_feature_dir_index(fs->super)) {
+    w.blocks.resize((size_t)(kMaxDxLevels + 1) * fs->blocksize);
+    return walkHtree(&w);
+  }
+  return ext2fs_dir_iterate2(fs, ino, DIRENT_FLAG_INCLUDE_EMPTY, NULL,
+                             countDirEntry, &w);
+}
+
+}  // namespace
+
+errcode_t walkFilesystem(ext2_filsys fs, uint64_t* budget, WalkStats* stats) {
+  ext2_inode_scan scan;
+  errcode_t retval = ext2fs_open_inode_scan(fs, 0, &scan);
+  if (retval != 0) return retval;
+
+  std::vector<char> buf(EXT2_INODE_SIZE(fs->super));
+  struct ext2_inode* inode = (struct ext2_inode*)buf.data();
+  ext2_ino_t ino;
+  while (*budget > 0) {
+    retval = ext2fs_get_next_inode_full(scan, &ino, inode, buf.size());
+    if (retval == EXT2_ET_BAD_BLOCK_IN_INODE_TABLE) continue;
+    if (retval != 0 || ino == 0) break;
+    if (inode->i_links_count == 0) continue;
+
+    stats->inodes++;
+    (*budget)--;
+    errcode_t walkError = 0;
+    if (inode->i_flags & EXT4_EXTENTS_FL) {
+      stats->extentFiles++;
+      walkError = walkExtents(fs, ino, inode, budget, stats);
+    }
+    if (walkError == 0 && LINUX_S_ISDIR(inode->i_mode) && *budget > 0) {
+      walkError = walkDirectory(fs, ino, inode, budget, stats);
+    }
+    if (walkError != 0) stats->errors++;
+  }
+
+  ext2fs_close_inode_scan(scan);
+  return retval == EXT2_ET_BAD_BLOCK_IN_INODE_TABLE ? 0 : retval;
+}
@@ -0,0 +1,33 @@
+// Walks the extent trees and directories of an ext2/3/4 filesystem.
+
+#ifndef EXT2FS_WALK_H_
+#define EXT2FS_WALK_H_
+
+#include <stdint.h>
+
+#include "ext2fs/ext2fs.h"
+
+struct WalkStats {
+  uint64_t inodes = 0;
+  uint64_t extentFiles = 0;  // Inodes with EXT4_EXTENTS_FL.
+  uint64_t extents = 0;      // Leaf extents.
+  uint64_t extentNodes = 0;  // Index entries above the leaves.
+  uint64_t dirs = 0;
+  uint64_t htreeDirs = 0;
+  uint64_t htreeNodes = 0;  // Root and interior index blocks.
+  uint64_t dirEntries = 0;
+  uint64_t errors = 0;  // Inodes whose walk stopped on a corrupt structure.
+};
+
+// Walk every in-use inode of fs. Files with EXT4_EXTENTS_FL have their extent
+// tree iterated with the ext2fs_extent_* API. Hashed directories are walked
+// from the dx root down through the index blocks to the leaf blocks; other
+// directories are read with ext2fs_dir_iterate2().
+//
+// Each inode, extent and directory entry visited, and each directory block
+// read, consumes one unit of *budget. The walk stops when it reaches zero.
+//
+// Return 0, or the error that stopped the inode scan.
+errcode_t walkFilesystem(ext2_filsys fs, uint64_t* budget, WalkStats* stats);
+
+#endif  // EXT2FS_WALK_H_
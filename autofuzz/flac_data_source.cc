@@ -0,0 +1,13 @@
+#include "flac_data_source.h"
+
+#include <string.h>
+
+ssize_t FuzzDataSource::readAt(off64_t offset, void *const data, size_t size) {
+  if (offset > size_)
+    return -1;
+  size_t remaining = size_ - offset;
+  if (remaining < size)
+    size = remaining;
+  memcpy(data, data_ + offset, size);
+  return size;
+}
@@ -0,0 +1,27 @@
+// In-memory DataSource for FLACParser, shared by the FLAC fuzz target and
+// benchmark.
+
+#ifndef FLAC_DATA_SOURCE_H_
+#define FLAC_DATA_SOURCE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "flac/fuzzer/flac_parser.h"
+
+// Reads from a caller-owned buffer. readAt() keeps no state, so one source
+// can be shared by parsers on several threads.
+class FuzzDataSource : public DataSource {
+  const uint8_t *data_;
+  size_t size_;
+
+ public:
+  FuzzDataSource(const uint8_t *data, size_t size) {
+    data_ = data;
+    size_ = size;
+  }
+
+  ssize_t readAt(off64_t offset, void *const data, size_t size);
+};
+
+#endif  // FLAC_DATA_SOURCE_H_
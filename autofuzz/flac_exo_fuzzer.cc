@@ -4,30 +4,7 @@
 
 #include <string>
 
-namespace {
-
-class FuzzDataSource : public DataSource {
-  const uint8_t *data_;
-  size_t size_;
-
- public:
-  FuzzDataSource(const uint8_t *data, size_t size) {
-    data_ = data;
-    size_ = size;
-  }
-
-  ssize_t readAt(off64_t offset, void *const data, size_t size) {
-    if (offset > size_)
-      return -1;
-    size_t remaining = size_ - offset;
-    if (remaining < size)
-      size = remaining;
-    memcpy(data, data_ + offset, size);
-    return size;
-  }
-};
-
-}  // namespace
+#include "flac_data_source.h"
 
 // Fuzz FLAC format and instrument the result as exoplayer JNI would:
 // https://github.com/google/ExoPlayer/blob/release-v2/extensions/flac/src/main/jni/
@@ -0,0 +1,286 @@
+// Frame-parallel decoding benchmark for FLACParser.
+//
+// flac_exo_fuzzer decodes a stream one readBuffer() at a time from the start.
+// FLAC frames do not depend on each other, so a file can be split into frame
+// ranges and each range decoded on its own thread. The split points come from
+// the SEEKTABLE block when it has enough points, and otherwise from a scan for
+// frame sync codes whose header CRC-8 checks out.
+//
+// Every thread decodes with its own FLACParser: it reads the metadata from the
+// start of the shared FuzzDataSource, then reset()s to the first frame of its
+// range. A bounded view over the shared source ends the stream at the next
+// range, so the parser stops on a frame boundary. The PCM of the ranges,
+// concatenated in order, must equal the PCM of a serial decode.
+//
+// Usage: flac_parallel_benchmark [-r repeats] [-t max_threads] file.flac...
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench_utils.h"
+#include "flac/fuzzer/flac_parser.h"
+#include "flac_data_source.h"
+
+namespace {
+
+const int kSeekTableBlock = 3;
+const size_t kSeekPointSize = 18;
+const uint64_t kPlaceholderSample = 0xffffffffffffffffull;
+
+// Ends another source at end, which is where the next range starts.
+class BoundedDataSource : public DataSource {
+  DataSource *source_;
+  off64_t end_;
+
+ public:
+  BoundedDataSource(DataSource *source, off64_t end)
+      : source_(source), end_(end) {}
+
+  ssize_t readAt(off64_t offset, void *const data, size_t size) {
+    if (offset > end_) return -1;
+    if ((off64_t)size > end_ - offset) size = end_ - offset;
+    return source_->readAt(offset, data, size);
+  }
+};
+
+uint64_t readBigEndian(const uint8_t *p, int bytes) {
+  uint64_t v = 0;
+  for (int i = 0; i < bytes; i++) v = (v << 8) | p[i];
+  return v;
+}
+
+// Walks the metadata blocks. Sets *firstFrame to the offset of the first frame
+// and fills seekOffsets with the absolute offsets of the seek points.
+bool readMetadata(const std::string &data, size_t *firstFrame,
+                  std::vector<size_t> *seekOffsets) {
+  const uint8_t *p = (const uint8_t *)data.data();
+  if (data.size() < 4 || memcmp(p, "fLaC", 4) != 0) return false;
+
+  std::vector<uint64_t> points;
+  size_t pos = 4;
+  bool last = false;
+  while (!last) {
+    if (pos + 4 > data.size()) return false;
+    last = (p[pos] & 0x80) != 0;
+    int type = p[pos] & 0x7f;
+    size_t length = readBigEndian(p + pos + 1, 3);
+    pos += 4;
+    if (pos + length > data.size()) return false;
+
+    if (type == kSeekTableBlock) {
+      for (size_t i = 0; i + kSeekPointSize <= length; i += kSeekPointSize) {
+        if (readBigEndian(p + pos + i, 8) == kPlaceholderSample) continue;
+        points.push_back(readBigEndian(p + pos + i + 8, 8));
+      }
+    }
+    pos += length;
+  }
+
+  *firstFrame = pos;
+  seekOffsets->clear();
+  for (uint64_t offset : points) {
+    if (offset < data.size() - pos) seekOffsets->push_back(pos + offset);
+  }
+  std::sort(seekOffsets->begin(), seekOffsets->end());
+  seekOffsets->erase(std::unique(seekOffsets->begin(), seekOffsets->end()),
+                     seekOffsets->end());
+  return true;
+}
+
+uint8_t crc8(const uint8_t *p, size_t n) {
+  uint8_t crc = 0;
+  for (size_t i = 0; i < n; i++) {
+    crc ^= p[i];
+    for (int b = 0; b < 8; b++) {
+      crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+    }
+  }
+  return crc;
+}
+
+// Return whether a frame header with a valid CRC-8 starts at p.
+bool isFrameHeader(const uint8_t *p, size_t avail) {
+  if (avail < 6 || p[0] != 0xff || (p[1] & 0xfe) != 0xf8) return false;
+  int blockSizeCode = p[2] >> 4;
+  int rateCode = p[2] & 0x0f;
+  int channelCode = p[3] >> 4;
+  int sampleSizeCode = (p[3] >> 1) & 0x07;
+  if (blockSizeCode == 0 || rateCode == 15 || channelCode > 10 ||
+      sampleSizeCode == 3 || (p[3] & 1) != 0) {
+    return false;
+  }
+
+  // UTF-8 coded frame or sample number.
+  size_t pos = 4;
+  int extra = 0;
+  if (p[pos] >= 0x80) {
+    while (extra < 7 && (p[pos] & (0x40 >> extra)) != 0) extra++;
+    if (extra == 0 || extra > 6) return false;
+  }
+  pos++;
+  for (int i = 0; i < extra; i++, pos++) {
+    if (pos >= avail || (p[pos] & 0xc0) != 0x80) return false;
+  }
+
+  if (blockSizeCode == 6) pos += 1;
+  if (blockSizeCode == 7) pos += 2;
+  if (rateCode == 12) pos += 1;
+  if (rateCode == 13 || rateCode == 14) pos += 2;
+  return pos < avail && crc8(p, pos) == p[pos];
+}
+
+size_t nextFrame(const std::string &data, size_t from) {
+  const uint8_t *p = (const uint8_t *)data.data();
+  for (size_t pos = from; pos + 1 < data.size(); pos++) {
+    if (isFrameHeader(p + pos, data.size() - pos)) return pos;
+  }
+  return data.size();
+}
+
+// Split [firstFrame, size) into at most n ranges starting on frame
+// boundaries. Returns the n + 1 (or fewer) boundaries.
+std::vector<size_t> partition(const std::string &data, size_t firstFrame,
+                              const std::vector<size_t> &seekOffsets, int n,
+                              bool *fromSeekTable) {
+  std::vector<size_t> bounds;
+  bounds.push_back(firstFrame);
+  *fromSeekTable = (int)seekOffsets.size() >= n;
+  for (int k = 1; k < n; k++) {
+    size_t bound;
+    if (*fromSeekTable) {
+      bound = seekOffsets[seekOffsets.size() * k / n];
+    } else {
+      size_t target = firstFrame + (data.size() - firstFrame) * k / n;
+      bound = nextFrame(data, std::max(target, bounds.back() + 1));
+    }
+    if (bound > bounds.back() && bound < data.size()) bounds.push_back(bound);
+  }
+  bounds.push_back(data.size());
+  return bounds;
+}
+
+// Decode the frames in [start, end) of source, appending the PCM to pcm.
+// Returns false if the metadata could not be read.
+bool decodeRange(DataSource *source, size_t start, size_t end,
+                 std::string *pcm) {
+  BoundedDataSource bounded(source, end);
+  FLACParser parser(&bounded);
+  if (!parser.init() || !parser.decodeMetadata()) return false;
+
+  auto streamInfo = parser.getStreamInfo();
+  // Room for 32-bit samples, whatever the stream's sample size.
+  std::vector<uint8_t> buffer((size_t)streamInfo.max_blocksize *
+                              streamInfo.channels * 4);
+  parser.reset(start);
+  for (;;) {
+    size_t n = parser.readBuffer(buffer.data(), buffer.size());
+    if (n == 0 || n > buffer.size()) break;
+    pcm->append((const char *)buffer.data(), n);
+  }
+  return true;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  int repeats = 3;
+  int maxThreads = std::thread::hardware_concurrency();
+  int opt;
+  while ((opt = getopt(argc, argv, "r:t:")) != -1) {
+    switch (opt) {
+      case 'r':
+        repeats = atoi(optarg);
+        break;
+      case 't':
+        maxThreads = atoi(optarg);
+        break;
+      default:
+        fprintf(stderr,
+                "usage: %s [-r repeats] [-t max_threads] file.flac...\n",
+                argv[0]);
+        return 1;
+    }
+  }
+  if (repeats < 1) repeats = 1;
+  if (maxThreads < 1) maxThreads = 1;
+
+  std::vector<int> threadCounts;
+  for (int n = 1; n < maxThreads; n *= 2) threadCounts.push_back(n);
+  threadCounts.push_back(maxThreads);
+
+  int status = 0;
+  std::string data;
+  for (int i = optind; i < argc; i++) {
+    const char *fileName = argv[i];
+    if (bench_read_file(fileName, &data) != 0) continue;
+
+    size_t firstFrame;
+    std::vector<size_t> seekOffsets;
+    if (!readMetadata(data, &firstFrame, &seekOffsets)) {
+      fprintf(stderr, "%s: skipped: no FLAC metadata\n", fileName);
+      continue;
+    }
+    FuzzDataSource source((const uint8_t *)data.data(), data.size());
+
+    std::string serial;
+    double serialSeconds = 0;
+    for (int r = 0; r < repeats; r++) {
+      serial.clear();
+      double start = bench_now();
+      decodeRange(&source, firstFrame, data.size(), &serial);
+      serialSeconds += bench_now() - start;
+    }
+
+    printf("%s: %zu bytes, %zu seek points, %.1f MB PCM\n", fileName,
+           data.size(), seekOffsets.size(), serial.size() / (1024.0 * 1024.0));
+    printf("%8s %8s %10s %12s %9s %7s\n", "threads", "ranges", "split",
+           "PCM MB/s", "speedup", "match");
+    double serialRate =
+        bench_mb_per_sec((double)serial.size() * repeats, serialSeconds);
+    printf("%8d %8d %10s %12.1f %8.2fx %7s\n", 1, 1, "serial", serialRate,
+           1.0, "-");
+
+    for (int n : threadCounts) {
+      bool fromSeekTable;
+      std::vector<size_t> bounds =
+          partition(data, firstFrame, seekOffsets, n, &fromSeekTable);
+      const size_t ranges = bounds.size() - 1;
+
+      std::vector<std::string> pcm(ranges);
+      double seconds = 0;
+      for (int r = 0; r < repeats; r++) {
+        std::vector<std::thread> threads;
+        double start = bench_now();
+        for (size_t k = 0; k < ranges; k++) {
+          pcm[k].clear();
+          threads.emplace_back([&, k]() {
+            decodeRange(&source, bounds[k], bounds[k + 1], &pcm[k]);
+          });
+        }
+        for (std::thread &t : threads) t.join();
+        seconds += bench_now() - start;
+      }
+
+      std::string joined;
+      for (const std::string &part : pcm) joined += part;
+      bool match = joined == serial;
+      if (!match) status = 1;
+
+      double rate = bench_mb_per_sec((double)joined.size() * repeats, seconds);
+      printf("%8d %8zu %10s %12.1f %8.2fx %7s\n", n, ranges,
+             fromSeekTable ? "seektable" : "sync scan", rate,
+             serialRate > 0 ? rate / serialRate : 0, match ? "yes" : "NO");
+    }
+  }
+
+  return status;
+}
@@ -0,0 +1,214 @@
+// Encode and decode scaling benchmark for GFWX.
+//
+// GFWX parallelises its transforms and per-block coding with OpenMP. This
+// driver encodes and decodes the same images with 1, 2, 4, ... OpenMP threads
+// and reports megapixels/sec for each direction, with the compression ratio.
+// Images are decoded from the .gfwx files given, or generated: a
+// deterministic 8-bit RGB gradient with noise, of -s width x height.
+//
+// Usage: gfwx_benchmark [-r repeats] [-t max_threads] [-q quality]
+//            [-b block] [-f filter] [-e encoder] [-s WxH] [file.gfwx...]
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "bench_utils.h"
+#include "gfwx/gfwx.h"
+
+namespace {
+
+struct Image {
+  std::string name;
+  GFWX::Header header;
+  std::vector<uint8_t> pixels;
+};
+
+Image syntheticImage(int width, int height) {
+  Image image;
+  image.name = "synthetic";
+  image.header.sizex = width;
+  image.header.sizey = height;
+  image.header.layers = 1;
+  image.header.channels = 3;
+  image.header.bitDepth = 8;
+  image.pixels.resize((size_t)width * height * 3);
+
+  uint32_t state = 0x9f3du;
+  uint8_t *p = image.pixels.data();
+  for (int y = 0; y < height; y++) {
+    for (int x = 0; x < width; x++, p += 3) {
+      state ^= state << 13;
+      state ^= state >> 17;
+      state ^= state << 5;
+      int noise = (int)(state & 15) - 8;
+      int r = x * 255 / width + noise;
+      int g = y * 255 / height + noise;
+      int b = (x + y) * 255 / (width + height) + noise;
+      p[0] = (uint8_t)(r < 0 ? 0 : r > 255 ? 255 : r);
+      p[1] = (uint8_t)(g < 0 ? 0 : g > 255 ? 255 : g);
+      p[2] = (uint8_t)(b < 0 ? 0 : b > 255 ? 255 : b);
+    }
+  }
+  return image;
+}
+
+bool decodeFile(const char *fileName, Image *image) {
+  std::string data;
+  if (bench_read_file(fileName, &data) != 0) return false;
+
+  const uint8_t *bytes = (const uint8_t *)data.data();
+  GFWX::Header &h = image->header;
+  if (GFWX::decompress(static_cast<uint8_t *>(nullptr), h, bytes,
+                       data.size(), 0, false) != GFWX::ResultOk ||
+      h.bufferSize() == 0) {
+    fprintf(stderr, "%s: skipped: not a readable GFWX image\n", fileName);
+    return false;
+  }
+
+  image->name = fileName;
+  image->pixels.resize(h.bufferSize());
+  return GFWX::decompress(image->pixels.data(), h, bytes, data.size(), 0,
+                          false) == GFWX::ResultOk;
+}
+
+void setThreads(int n) {
+#ifdef _OPENMP
+  omp_set_num_threads(n);
+#else
+  (void)n;
+#endif
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  int repeats = 3;
+  int maxThreads = 1;
+#ifdef _OPENMP
+  maxThreads = omp_get_max_threads();
+#endif
+  int quality = GFWX::QualityMax;
+  int blockSize = GFWX::BlockDefault;
+  int filter = GFWX::FilterLinear;
+  int encoder = GFWX::EncoderTurbo;
+  int width = 1920;
+  int height = 1080;
+  int opt;
+  while ((opt = getopt(argc, argv, "r:t:q:b:f:e:s:")) != -1) {
+    switch (opt) {
+      case 'r':
+        repeats = atoi(optarg);
+        break;
+      case 't':
+        maxThreads = atoi(optarg);
+        break;
+      case 'q':
+        quality = atoi(optarg);
+        break;
+      case 'b':
+        blockSize = atoi(optarg);
+        break;
+      case 'f':
+        filter = atoi(optarg);
+        break;
+      case 'e':
+        encoder = atoi(optarg);
+        break;
+      case 's':
+        if (sscanf(optarg, "%dx%d", &width, &height) != 2) {
+          optind = argc + 1;
+        }
+        break;
+      default:
+        optind = argc + 1;
+        break;
+    }
+  }
+  if (optind > argc || width < 1 || height < 1) {
+    fprintf(stderr,
+            "usage: %s [-r repeats] [-t max_threads] [-q quality] [-b block] "
+            "[-f filter] [-e encoder] [-s WxH] [file.gfwx...]\n",
+            argv[0]);
+    return 1;
+  }
+  if (repeats < 1) repeats = 1;
+  if (maxThreads < 1) maxThreads = 1;
+#ifndef _OPENMP
+  if (maxThreads > 1) {
+    fprintf(stderr, "built without OpenMP, running single threaded\n");
+    maxThreads = 1;
+  }
+#endif
+
+  std::vector<Image> images;
+  for (int i = optind; i < argc; i++) {
+    Image image;
+    if (decodeFile(argv[i], &image)) images.push_back(image);
+  }
+  if (optind == argc) images.push_back(syntheticImage(width, height));
+
+  std::vector<int> threadCounts;
+  for (int n = 1; n < maxThreads; n *= 2) threadCounts.push_back(n);
+  threadCounts.push_back(maxThreads);
+
+  printf("quality: %d, block: %d, filter: %d, encoder: %d\n", quality,
+         blockSize, filter, encoder);
+  printf("%-24s %8s %12s %12s %8s\n", "image", "threads", "encode MP/s",
+         "decode MP/s", "ratio");
+
+  std::vector<uint8_t> encoded;
+  std::vector<uint8_t> decoded;
+  for (const Image &image : images) {
+    const GFWX::Header &h = image.header;
+    GFWX::Header header(h.sizex, h.sizey, h.layers, h.channels, h.bitDepth,
+                        quality, 1 /* chromaScale */, blockSize, filter,
+                        GFWX::QuantizationScalar, encoder,
+                        GFWX::IntentGeneric);
+    const double megapixels = (double)h.sizex * h.sizey * h.layers / 1e6;
+    encoded.resize(2 * image.pixels.size() + 4096);
+    decoded.resize(image.pixels.size());
+
+    for (int n : threadCounts) {
+      setThreads(n);
+
+      ptrdiff_t encodedSize = 0;
+      double start = bench_now();
+      for (int r = 0; r < repeats; r++) {
+        encodedSize = GFWX::compress(image.pixels.data(), header,
+                                     encoded.data(), encoded.size(), nullptr,
+                                     nullptr, 0);
+      }
+      double encodeSeconds = bench_now() - start;
+      if (encodedSize <= 0) {
+        fprintf(stderr, "%s: compress failed: %td\n", image.name.c_str(),
+                encodedSize);
+        break;
+      }
+
+      GFWX::Header back;
+      start = bench_now();
+      for (int r = 0; r < repeats; r++) {
+        GFWX::decompress(decoded.data(), back, encoded.data(), encodedSize, 0,
+                         false);
+      }
+      double decodeSeconds = bench_now() - start;
+
+      printf("%-24s %8d %12.1f %12.1f %7.2fx\n", image.name.c_str(), n,
+             encodeSeconds > 0 ? megapixels * repeats / encodeSeconds : 0,
+             decodeSeconds > 0 ? megapixels * repeats / decodeSeconds : 0,
+             (double)image.pixels.size() / encodedSize);
+    }
+  }
+
+  return 0;
+}
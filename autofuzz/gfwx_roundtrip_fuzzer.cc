@@ -0,0 +1,103 @@
+// Decodes a GFWX image, re-encodes it with GFWX::compress and decodes the
+// result again. The quality, chroma scale, block size, filter and encoder of
+// the re-encode are picked from a hash of the input, so that every input maps
+// to one fixed set of parameters. At full quality with an unscaled chroma the
+// codec is lossless, and the re-decoded pixels must match the first decode.
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <vector>
+
+#include "gfwx/gfwx.h"
+
+namespace {
+
+// Round trips are several times slower than gfwx_decompress_fuzzer's decode,
+// so keep images smaller than its 512 MB buffer.
+const size_t kMaxImageBytes = 1 << 26;  // 64 MB.
+
+const int kQualities[] = {1, 16, 128, 512, 1023, GFWX::QualityMax};
+const int kChromaScales[] = {1, 1, 2, 8};
+const int kFilters[] = {GFWX::FilterLinear, GFWX::FilterCubic};
+const int kEncoders[] = {GFWX::EncoderTurbo, GFWX::EncoderFast,
+                         GFWX::EncoderContextual};
+
+template <typename T, size_t N>
+int pick(const T (&values)[N], uint32_t *state) {
+  *state ^= *state << 13;
+  *state ^= *state >> 17;
+  *state ^= *state << 5;
+  return values[*state % N];
+}
+
+uint32_t hashInput(const uint8_t *data, size_t size) {
+  uint32_t hash = 2166136261u;  // FNV-1a.
+  for (size_t i = 0; i < size; i++) hash = (hash ^ data[i]) * 16777619u;
+  return hash ? hash : 1;
+}
+
+// Reused across runs so that large images do not reallocate every time.
+std::vector<uint8_t> image;
+std::vector<uint8_t> encoded;
+std::vector<uint8_t> reread;
+
+}  // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+  GFWX::Header h;
+  if (GFWX::decompress(static_cast<uint8_t *>(nullptr), h, data, size,
+                       0 /* downsampling */,
+                       false /* test */) != GFWX::ResultOk) {
+    return 0;
+  }
+
+  size_t sz = h.bufferSize();
+  if (sz == 0 || sz > kMaxImageBytes) {
+    return 0;
+  }
+  if (image.size() < sz) image.resize(sz);
+  if (GFWX::decompress(image.data(), h, data, size, 0 /* downsampling */,
+                       false /* test */) != GFWX::ResultOk) {
+    return 0;
+  }
+
+  uint32_t state = hashInput(data, size);
+  GFWX::Header out(h.sizex, h.sizey, h.layers, h.channels, h.bitDepth,
+                   pick(kQualities, &state), pick(kChromaScales, &state),
+                   1 + state % GFWX::BlockMax, pick(kFilters, &state),
+                   GFWX::QuantizationScalar, pick(kEncoders, &state),
+                   h.intent);
+
+  // Incompressible data can come out larger than the raw pixels.
+  size_t encodedCapacity = 2 * sz + 4096;
+  if (encoded.size() < encodedCapacity) encoded.resize(encodedCapacity);
+  ptrdiff_t encodedSize =
+      GFWX::compress(image.data(), out, encoded.data(), encodedCapacity,
+                     nullptr /* channelTransform */, nullptr /* metaData */,
+                     0 /* metaDataSize */);
+  if (encodedSize <= 0) {
+    return 0;
+  }
+
+  GFWX::Header back;
+  if (reread.size() < sz) reread.resize(sz);
+  if (GFWX::decompress(reread.data(), back, encoded.data(), encodedSize,
+                       0 /* downsampling */,
+                       false /* test */) != GFWX::ResultOk) {
+    return 0;
+  }
+
+  // bufferSize() allows (bitDepth + 7) / 8 bytes per sample, but decoding
+  // into uint8_t writes one, so only those are compared. The rest of the
+  // reused buffers holds whatever earlier inputs left there.
+  const size_t samples = (size_t)h.sizex * h.sizey * h.layers * h.channels;
+  bool lossless = out.quality == GFWX::QualityMax && out.chromaScale == 1;
+  if (lossless && memcmp(image.data(), reread.data(), samples) != 0) {
+    abort();
+  }
+
+  return 0;
+}
@@ -0,0 +1,182 @@
+#include "graphviz_arena.h"
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define GRAPHVIZ_ARENA_ASAN 1
+#endif
+#endif
+#if defined(__SANITIZE_ADDRESS__) && !defined(GRAPHVIZ_ARENA_ASAN)
+#define GRAPHVIZ_ARENA_ASAN 1
+#endif
+
+#ifdef GRAPHVIZ_ARENA_ASAN
+#include <sanitizer/asan_interface.h>
+#endif
+
+namespace {
+
+const size_t kChunkSize = 1 << 16;
+const size_t kAlignment = alignof(max_align_t);
+
+struct Chunk {
+  Chunk* next;
+  size_t size;
+  size_t used;
+  // Followed by size bytes of zeroed memory.
+};
+
+const size_t kHeaderSize =
+    (sizeof(Chunk) + kAlignment - 1) & ~(kAlignment - 1);
+
+struct Arena {
+  Chunk* chunks;
+};
+
+char* chunkData(Chunk* chunk) {
+  return reinterpret_cast<char*>(chunk) + kHeaderSize;
+}
+
+void* arenaOpen(Agdisc_t*) {
+  return calloc(1, sizeof(Arena));
+}
+
+// Carve req bytes out of the current chunk, or a new one. cgraph expects
+// zeroed memory, as from AgMemDisc. Chunks come from calloc() and are never
+// reused, so nothing has to be cleared here.
+char* carve(Arena* arena, size_t req) {
+  req = (req + kAlignment - 1) & ~(kAlignment - 1);
+
+  Chunk* chunk = arena->chunks;
+  if (chunk == NULL || chunk->size - chunk->used < req) {
+    size_t size = req > kChunkSize ? req : kChunkSize;
+    chunk = static_cast<Chunk*>(calloc(1, kHeaderSize + size));
+    if (chunk == NULL) return NULL;
+    chunk->size = size;
+#ifdef GRAPHVIZ_ARENA_ASAN
+    ASAN_POISON_MEMORY_REGION(chunkData(chunk), size);
+#endif
+    // Keep filling the current chunk after an oversized allocation.
+    if (req > kChunkSize && arena->chunks != NULL) {
+      chunk->next = arena->chunks->next;
+      arena->chunks->next = chunk;
+    } else {
+      chunk->next = arena->chunks;
+      arena->chunks = chunk;
+    }
+  }
+
+  char* p = chunkData(chunk) + chunk->used;
+  chunk->used += req;
+  return p;
+}
+
+#ifdef GRAPHVIZ_ARENA_ASAN
+
+// Under ASan, chunks start out poisoned. Every block is preceded by a
+// kAlignment byte header holding its size and followed by a redzone of the
+// same size, both of which stay poisoned. Freed and resized-away blocks are
+// poisoned again and never reused, so overflows and uses after free are
+// still reported.
+const size_t kRedzone = kAlignment;
+
+void* arenaAlloc(void* state, size_t req) {
+  char* block = carve(static_cast<Arena*>(state), kRedzone + req + kRedzone);
+  if (block == NULL) return NULL;
+
+  ASAN_UNPOISON_MEMORY_REGION(block, sizeof(size_t));
+  memcpy(block, &req, sizeof(size_t));
+  ASAN_POISON_MEMORY_REGION(block, sizeof(size_t));
+  ASAN_UNPOISON_MEMORY_REGION(block + kRedzone, req);
+  return block + kRedzone;
+}
+
+void arenaFree(void*, void* ptr) {
+  if (ptr == NULL) return;
+  char* block = static_cast<char*>(ptr) - kRedzone;
+  size_t size;
+  ASAN_UNPOISON_MEMORY_REGION(block, sizeof(size_t));
+  memcpy(&size, block, sizeof(size_t));
+  ASAN_POISON_MEMORY_REGION(block, sizeof(size_t));
+  ASAN_POISON_MEMORY_REGION(ptr, size);
+}
+
+// Always move, even to shrink, so that the old block can be poisoned.
+void* arenaResize(void* state, void* ptr, size_t old, size_t req) {
+  void* p = arenaAlloc(state, req);
+  if (p != NULL && ptr != NULL) {
+    memcpy(p, ptr, old < req ? old : req);
+    arenaFree(state, ptr);
+  }
+  return p;
+}
+
+#else
+
+void* arenaAlloc(void* state, size_t req) {
+  return carve(static_cast<Arena*>(state), req);
+}
+
+void* arenaResize(void* state, void* ptr, size_t old, size_t req) {
+  if (req <= old) return ptr;
+  void* p = arenaAlloc(state, req);
+  if (p != NULL && ptr != NULL) memcpy(p, ptr, old);
+  return p;
+}
+
+void arenaFree(void*, void*) {}
+
+#endif  // GRAPHVIZ_ARENA_ASAN
+
+void arenaClose(void* state) {
+  Arena* arena = static_cast<Arena*>(state);
+  Chunk* chunk = arena->chunks;
+  while (chunk != NULL) {
+    Chunk* next = chunk->next;
+#ifdef GRAPHVIZ_ARENA_ASAN
+    ASAN_UNPOISON_MEMORY_REGION(chunkData(chunk), chunk->size);
+#endif
+    free(chunk);
+    chunk = next;
+  }
+  free(arena);
+}
+
+// The in-memory reader of agmemread(), which is private to cgraph's io.c.
+struct MemReader {
+  const char* data;
+  size_t len;
+  size_t cur;
+};
+
+// Hand out one line at a time, like agmemread().
+int memRead(void* chan, char* buf, int bufsize) {
+  MemReader* reader = static_cast<MemReader*>(chan);
+  if (bufsize <= 0 || reader->cur >= reader->len) return 0;
+
+  int n = 0;
+  while (n < bufsize && reader->cur < reader->len) {
+    char c = reader->data[reader->cur++];
+    buf[n++] = c;
+    if (c == '\n') break;
+  }
+  return n;
+}
+
+}  // namespace
+
+Agmemdisc_t ArenaMemDisc = {arenaOpen, arenaAlloc, arenaResize, arenaFree,
+                            arenaClose};
+
+Agraph_t* arenaMemRead(const char* cp) {
+  // cgraph keeps a copy of the discipline, so the parts it points to must
+  // outlive the graph.
+  static Agiodisc_t memIoDisc = {memRead, AgIoDisc.putstr, AgIoDisc.flush};
+  static Agdisc_t disc = {&ArenaMemDisc, &AgIdDisc, &memIoDisc};
+
+  MemReader reader = {cp, strlen(cp), 0};
+  return agread(&reader, &disc);
+}
@@ -0,0 +1,23 @@
+// An arena memory discipline for cgraph: every record of a graph is carved out
+// of large chunks, nothing is freed one by one, and agclose() releases all the
+// chunks at once.
+
+#ifndef GRAPHVIZ_ARENA_H_
+#define GRAPHVIZ_ARENA_H_
+
+#include "lib/gvc/gvc.h"
+
+// Memory discipline with one arena per root graph. free() is a no-op, so
+// memory released before agclose(), such as by gvFreeLayout(), is only
+// reclaimed when the graph is closed.
+//
+// In ASan builds blocks get redzones, and free() and resizing poison the
+// block they release, so that the fuzzers still catch overflows and uses
+// after free of cgraph records. Each block then takes two more
+// alignof(max_align_t) bytes of arena.
+extern Agmemdisc_t ArenaMemDisc;
+
+// agmemread() with ArenaMemDisc as the memory discipline.
+Agraph_t* arenaMemRead(const char* cp);
+
+#endif  // GRAPHVIZ_ARENA_H_
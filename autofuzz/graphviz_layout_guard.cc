@@ -0,0 +1,139 @@
+#include "graphviz_layout_guard.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace {
+
+// Rough number of node or edge visits that a layout may spend, summed over
+// its iterations.
+const double kLayoutWork = 1 << 22;
+
+// Below this many nodes plus edges the engine defaults finish quickly, so
+// only limits that the graph loosens itself are replaced.
+const double kMinGuardedSize = 500;
+
+// Passes over the graph per mclimit unit: dot's mincross runs up to 24
+// iterations in each of a few passes.
+const double kMincrossPasses = 96;
+
+double clamp(double v, double lo, double hi) {
+  return v < lo ? lo : v > hi ? hi : v;
+}
+
+// The graph's own value of name, or fallback if it does not set one.
+double graphValue(Agraph_t* g, const char* name, double fallback,
+                  bool* isSet) {
+  char* value = agget(g, const_cast<char*>(name));
+  *isSet = value != NULL && value[0] != '\0';
+  if (!*isSet) return fallback;
+
+  char* end;
+  double v = strtod(value, &end);
+  return end == value ? fallback : v;
+}
+
+struct Guard {
+  Agraph_t* graph;
+  bool large;
+  bool clamped;
+  bool injected;
+};
+
+// Replace name with bound when the graph's value, or fallback when it sets
+// none, is looser: above bound, or below it when atLeast is set.
+void limit(Guard* guard, const char* name, double bound, double fallback,
+           bool atLeast) {
+  bool isSet;
+  double value = graphValue(guard->graph, name, fallback, &isSet);
+  if (atLeast ? value >= bound : value <= bound) return;
+  if (!isSet && !guard->large) return;
+
+  char buf[32];
+  snprintf(buf, sizeof(buf), "%g", bound);
+  agsafeset(guard->graph, const_cast<char*>(name), buf,
+            const_cast<char*>(""));
+  if (isSet) {
+    guard->clamped = true;
+  } else {
+    guard->injected = true;
+  }
+}
+
+struct Limits {
+  double maxiter;
+  double maxiterDefault;
+  double ns;
+  double mclimit;
+  double searchsize;
+  double epsilon;
+  double epsilonDefault;
+};
+
+void limitAll(Guard* guard, const Limits& l) {
+  limit(guard, "maxiter", l.maxiter, l.maxiterDefault, false);
+  limit(guard, "nslimit", l.ns, HUGE_VAL, false);
+  limit(guard, "nslimit1", l.ns, HUGE_VAL, false);
+  limit(guard, "mclimit", l.mclimit, 1, false);
+  limit(guard, "searchsize", l.searchsize, 30, false);
+  limit(guard, "epsilon", l.epsilon, l.epsilonDefault, true);
+}
+
+// dot reads nslimit1 and friends again on every cluster, so values set on
+// subgraphs are clamped too. Nothing is added to subgraphs: unset, they take
+// the root graph's value.
+void limitSubgraphs(Guard* root, Agraph_t* g, const Limits& l) {
+  for (Agraph_t* sub = agfstsubg(g); sub != NULL; sub = agnxtsubg(sub)) {
+    Guard guard = {sub, false, false, false};
+    limitAll(&guard, l);
+    if (guard.clamped) root->clamped = true;
+    limitSubgraphs(root, sub, l);
+  }
+}
+
+}  // namespace
+
+bool guardLayout(Agraph_t* g, LayoutGuardStats* stats) {
+  const double nodes = agnnodes(g);
+  const double size = nodes + agnedges(g);
+
+  Guard guard = {g, size >= kMinGuardedSize, false, false};
+  if (size > 0) {
+    Limits l;
+    // neato's Kamada-Kawai mode moves one node per iteration, touching every
+    // other node, and defaults to maxiter = 100 * N and epsilon = 0.0001 * N.
+    // Stress majorization, fdp and sfdp pass over every node and edge per
+    // iteration and default to 1000 and 0.0001.
+    const char* mode = agget(g, const_cast<char*>("mode"));
+    if (mode != NULL && strcmp(mode, "KK") == 0) {
+      l.maxiterDefault = 100 * nodes;
+      l.maxiter = floor(clamp(kLayoutWork / nodes, 10, l.maxiterDefault));
+      l.epsilonDefault = 1e-4 * nodes;
+    } else {
+      l.maxiterDefault = 1000;
+      l.maxiter = floor(clamp(kLayoutWork / size, 10, 1000));
+      l.epsilonDefault = 1e-4;
+    }
+    // dot's network simplex runs nslimit * nodes iterations, each of which
+    // may look at every edge.
+    l.ns = clamp(kLayoutWork / (size * (nodes > 0 ? nodes : 1)), 0.01, 100);
+    l.mclimit = clamp(kLayoutWork / (kMincrossPasses * size), 0.05, 1);
+    l.searchsize = floor(clamp(kLayoutWork / (4 * size), 5, 30));
+    // neato stops once the energy changes by less than epsilon.
+    l.epsilon = clamp(size / kLayoutWork, 1e-4, 0.1);
+
+    limitAll(&guard, l);
+    limitSubgraphs(&guard, g, l);
+  }
+
+  bool guarded = guard.clamped || guard.injected;
+  if (stats != NULL) {
+    stats->graphs++;
+    if (guarded) stats->guarded++;
+    if (guard.clamped) stats->clamped++;
+    if (guard.injected) stats->injected++;
+  }
+  return guarded;
+}
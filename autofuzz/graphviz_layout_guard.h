@@ -0,0 +1,33 @@
+// Iteration limits for graphviz layout engines, scaled to the graph size, so
+// that a small input cannot keep neato, fdp, sfdp or dot busy for seconds.
+
+#ifndef GRAPHVIZ_LAYOUT_GUARD_H_
+#define GRAPHVIZ_LAYOUT_GUARD_H_
+
+#include <stddef.h>
+
+#include "lib/gvc/gvc.h"
+
+// The layout engines that graphviz_render_fuzzer picks from, also swept by
+// graphviz_scaling_benchmark.
+const char* const kLayoutEngines[] = {"circo", "dot",       "fdp",  "neato",
+                                      "osage", "patchwork", "sfdp", "twopi"};
+
+struct LayoutGuardStats {
+  size_t graphs;
+  size_t guarded;   // Graphs with at least one limit set.
+  size_t clamped;   // Graphs whose own value of a limit was too loose.
+  size_t injected;  // Graphs large enough to need limits they did not set.
+};
+
+// Set maxiter, nslimit, nslimit1, mclimit and searchsize to at most, and
+// epsilon to at least, values derived from the node and edge count of g.
+// Values the graph or any of its subgraphs sets itself are only replaced when
+// they are looser than the limit. Unset attributes are only added to the root
+// graph, once it is above a size at which the engines' defaults stop being
+// cheap; the defaults compared against follow neato's mode.
+//
+// Return whether any attribute was set. stats may be NULL.
+bool guardLayout(Agraph_t* g, LayoutGuardStats* stats);
+
+#endif  // GRAPHVIZ_LAYOUT_GUARD_H_
@@ -1,12 +1,14 @@
 #include <string>
 
+#include "graphviz_arena.h"
 #include "lib/gvc/gvc.h"
 
 extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
   if (size < 3) return 0;
   std::string s(reinterpret_cast<const char*>(data), size);
   agseterr(AGMAX);  // Don't print to stderr.
-  if (auto a = agmemread(s.c_str())) {
+  // Records live in one arena per graph, released at once by agclose().
+  if (auto a = arenaMemRead(s.c_str())) {
     agclose(a);
   }
   return 0;
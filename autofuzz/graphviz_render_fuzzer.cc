@@ -3,9 +3,13 @@
 // //visualization/graphviz_server/internal/gv-renderer.cc
 
 #include <fuzzer/FuzzedDataProvider.h>
+#include <stdio.h>
+#include <stdlib.h>
 
 #include <string>
 
+#include "graphviz_arena.h"
+#include "graphviz_layout_guard.h"
 #include "lib/gvc/gvc.h"
 
 
@@ -21,8 +25,25 @@ const char* FORMATS[] = {
   "plain-ext", "png",       "pov",  "ps",   "ps2",   "psd",     "sgi",
   "svg",       "svgz",      "tga",  "tif",  "tiff",  "tk",      "vml",
   "vmlz",      "vrml",      "wbmp", "webp", "xlib",  "x11"};
-const char* ENGINES [] = {"circo", "dot",       "fdp",  "neato",
-                          "osage", "patchwork", "sfdp", "twopi"};
+
+// How often guardLayout() had to limit an input, reported at exit when
+// GRAPHVIZ_GUARD_STATS is set.
+LayoutGuardStats guard_stats;
+
+void PrintGuardStats() {
+  fprintf(stderr,
+          "layout guard: %zu of %zu graphs limited (%zu clamped, %zu "
+          "injected)\n",
+          guard_stats.guarded, guard_stats.graphs, guard_stats.clamped,
+          guard_stats.injected);
+}
+
+int RegisterGuardStats() {
+  if (getenv("GRAPHVIZ_GUARD_STATS")) atexit(PrintGuardStats);
+  return 0;
+}
+
+int guard_stats_registered = RegisterGuardStats();
 
 
 extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
@@ -30,15 +51,20 @@ extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
 
   FuzzedDataProvider provider(data, size);
   const char* format = provider.PickValueInArray(FORMATS);
-  const char* engine = provider.PickValueInArray(ENGINES);
+  const char* engine = provider.PickValueInArray(kLayoutEngines);
   agseterr(AGMAX);  // Don't print to stderr.
 
-  auto graph = agmemread(provider.ConsumeRemainingBytesAsString().c_str());
+  // Records live in one arena per graph, released at once by agclose().
+  auto graph =
+      arenaMemRead(provider.ConsumeRemainingBytesAsString().c_str());
 
   if (!graph){
     return 0;
   }
 
+  // Keep iterative engines from running for seconds on adversarial graphs.
+  guardLayout(graph, &guard_stats);
+
   if (int result = gvLayout(gv_context, graph, engine)) {
     size_t output_length = 0;
     char* output_buffer = NULL;
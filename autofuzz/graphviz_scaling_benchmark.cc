@@ -0,0 +1,261 @@
+// Graph size scaling benchmark for the graphviz layout engines.
+//
+// Generates chains, binary trees, random sparse graphs and clusters of
+// densely connected nodes with N = 10, 100, ... up to -n nodes, and lays each
+// one out with every engine of graphviz_render_fuzzer (kLayoutEngines),
+// through the same agmemread() and gvLayout() calls on one shared GVC_t. For
+// each engine and shape it reports the parse and layout times and the heap
+// held per node once laid out, then fits layout time ~ N^k over the sizes and
+// flags k > 1.2 as super-linear. Each engine first lays out a two-node graph,
+// untimed, so that loading its plugin is not counted against N = 10.
+//
+// Before each size, its layout time is estimated from the previous one and
+// the exponent fitted so far (at least linear). If the estimate, or an actual
+// layout, exceeds -T seconds, larger sizes of that shape are skipped for that
+// engine. With -g, guardLayout() limits the iterations first, as
+// graphviz_render_fuzzer does.
+//
+// Usage: graphviz_scaling_benchmark [-g] [-n max_nodes] [-T max_seconds]
+//            [engine...]
+
+#include <malloc.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+#include "bench_utils.h"
+#include "graphviz_layout_guard.h"
+#include "lib/gvc/gvc.h"
+
+namespace {
+
+const char* SHAPES[] = {"chain", "tree", "sparse", "clusters"};
+
+const int kClusterSize = 20;
+const double kSuperLinear = 1.2;
+// Layouts faster than this are mostly timer and setup noise, so they are
+// left out of the fit.
+const double kMinFitSeconds = 1e-3;
+
+// xorshift32, so that generated graphs are identical across machines.
+uint32_t nextRandom(uint32_t* state) {
+  *state ^= *state << 13;
+  *state ^= *state >> 17;
+  *state ^= *state << 5;
+  return *state;
+}
+
+void appendEdge(std::string* dot, int from, int to) {
+  char buf[48];
+  snprintf(buf, sizeof(buf), "n%d -> n%d;\n", from, to);
+  *dot += buf;
+}
+
+std::string generateGraph(const char* shape, int n) {
+  std::string dot = "digraph G {\n";
+  uint32_t state = 0x61u + n;
+  if (strcmp(shape, "chain") == 0) {
+    for (int i = 0; i + 1 < n; i++) appendEdge(&dot, i, i + 1);
+  } else if (strcmp(shape, "tree") == 0) {
+    for (int i = 1; i < n; i++) appendEdge(&dot, (i - 1) / 2, i);
+  } else if (strcmp(shape, "sparse") == 0) {
+    for (int i = 0; i < n; i++) {
+      char buf[32];
+      snprintf(buf, sizeof(buf), "n%d;\n", i);
+      dot += buf;
+    }
+    for (int i = 0; i < 2 * n; i++) {
+      appendEdge(&dot, nextRandom(&state) % n, nextRandom(&state) % n);
+    }
+  } else {
+    for (int first = 0; first < n; first += kClusterSize) {
+      int last = first + kClusterSize < n ? first + kClusterSize : n;
+      char buf[48];
+      snprintf(buf, sizeof(buf), "subgraph cluster_%d {\n",
+               first / kClusterSize);
+      dot += buf;
+      for (int i = first; i < last; i++) {
+        for (int k = 0; k < 5; k++) {
+          appendEdge(&dot, i, first + nextRandom(&state) % (last - first));
+        }
+      }
+      dot += "}\n";
+      if (last < n) appendEdge(&dot, first, last);
+    }
+  }
+  dot += "}\n";
+  return dot;
+}
+
+// Lay out a small graph once, untimed, so that loading the engine's plugin
+// into the context is not counted against the first size.
+void warmUp(GVC_t* gv_context, const char* engine) {
+  Agraph_t* graph = agmemread("digraph G { a -> b; }");
+  if (!graph) return;
+  if (gvLayout(gv_context, graph, engine) == 0) {
+    gvFreeLayout(gv_context, graph);
+  }
+  agclose(graph);
+}
+
+size_t heapInUse() {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 33)
+  struct mallinfo2 info = mallinfo2();
+  return info.uordblks + info.hblkhd;
+#else
+  struct mallinfo info = mallinfo();
+  return (size_t)(unsigned)info.uordblks + (size_t)(unsigned)info.hblkhd;
+#endif
+}
+
+struct Point {
+  int nodes;
+  double seconds;
+};
+
+// Least squares slope of log(seconds) over log(nodes), or 0 with fewer than
+// two usable points.
+double scalingExponent(const std::vector<Point>& points) {
+  double n = 0, sx = 0, sy = 0, sxx = 0, sxy = 0;
+  for (const Point& p : points) {
+    if (p.seconds < kMinFitSeconds) continue;
+    double x = log((double)p.nodes);
+    double y = log(p.seconds);
+    n++;
+    sx += x;
+    sy += y;
+    sxx += x * x;
+    sxy += x * y;
+  }
+  double d = n * sxx - sx * sx;
+  return n >= 2 && d > 0 ? (n * sxy - sx * sy) / d : 0;
+}
+
+// Layout time for nodes extrapolated from the last point with the exponent
+// fitted so far. Layout is assumed to be at least linear, since every engine
+// visits every node.
+double estimateSeconds(const std::vector<Point>& points, int nodes) {
+  if (points.empty()) return 0;
+  double k = scalingExponent(points);
+  if (k < 1) k = 1;
+  const Point& last = points.back();
+  return last.seconds * pow((double)nodes / last.nodes, k);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  bool guard = false;
+  int maxNodes = 100000;
+  double maxSeconds = 10;
+  int opt;
+  while ((opt = getopt(argc, argv, "gn:T:")) != -1) {
+    switch (opt) {
+      case 'g':
+        guard = true;
+        break;
+      case 'n':
+        maxNodes = atoi(optarg);
+        break;
+      case 'T':
+        maxSeconds = atof(optarg);
+        break;
+      default:
+        fprintf(stderr,
+                "usage: %s [-g] [-n max_nodes] [-T max_seconds] "
+                "[engine...]\n",
+                argv[0]);
+        return 1;
+    }
+  }
+
+  std::vector<const char*> engines(argv + optind, argv + argc);
+  if (engines.empty()) {
+    engines.assign(kLayoutEngines,
+                   kLayoutEngines +
+                       sizeof(kLayoutEngines) / sizeof(kLayoutEngines[0]));
+  }
+
+  agseterr(AGMAX);  // Don't print to stderr.
+  GVC_t* gv_context = gvContextPlugins(lt_preloaded_symbols, 0);
+
+  printf("%-10s %-9s %8s %12s %12s %12s\n", "engine", "shape", "nodes",
+         "parse s", "layout s", "bytes/node");
+  std::vector<std::string> summary;
+  for (const char* engine : engines) {
+    warmUp(gv_context, engine);
+    for (const char* shape : SHAPES) {
+      std::vector<Point> points;
+      int cutoff = 0;
+      int skipped = 0;  // The size whose estimate exceeded -T, if any.
+      double estimate = 0;
+      for (int n = 10; n <= maxNodes; n *= 10) {
+        estimate = estimateSeconds(points, n);
+        if (estimate > maxSeconds) {
+          cutoff = points.back().nodes;
+          skipped = n;
+          break;
+        }
+        std::string dot = generateGraph(shape, n);
+
+        size_t heapBefore = heapInUse();
+        double start = bench_now();
+        Agraph_t* graph = agmemread(dot.c_str());
+        if (!graph) {
+          fprintf(stderr, "%s: %s/%d does not parse\n", engine, shape, n);
+          break;
+        }
+        double parseSeconds = bench_now() - start;
+
+        if (guard) guardLayout(graph, NULL);
+        start = bench_now();
+        int result = gvLayout(gv_context, graph, engine);
+        double seconds = bench_now() - start;
+        size_t heapAfter = heapInUse();
+        gvFreeLayout(gv_context, graph);
+        agclose(graph);
+        if (result != 0) {
+          fprintf(stderr, "%s: layout of %s/%d failed\n", engine, shape, n);
+          break;
+        }
+
+        double bytesPerNode =
+            heapAfter > heapBefore ? (double)(heapAfter - heapBefore) / n : 0;
+        printf("%-10s %-9s %8d %12.4f %12.4f %12.0f\n", engine, shape, n,
+               parseSeconds, seconds, bytesPerNode);
+        fflush(stdout);
+        points.push_back({n, seconds});
+        if (seconds > maxSeconds) {
+          cutoff = n;
+          break;
+        }
+      }
+
+      double k = scalingExponent(points);
+      char line[160];
+      snprintf(line, sizeof(line), "%-10s %-9s %8.2f %-12s", engine, shape, k,
+               k > kSuperLinear ? "super-linear" : "");
+      summary.push_back(line);
+      if (cutoff) {
+        snprintf(line, sizeof(line), " stopped after N=%d", cutoff);
+        summary.back() += line;
+      }
+      if (skipped) {
+        snprintf(line, sizeof(line), " (N=%d estimated at %.3g s)", skipped,
+                 estimate);
+        summary.back() += line;
+      }
+    }
+  }
+
+  printf("\n%-10s %-9s %8s\n", "engine", "shape", "N^k");
+  for (const std::string& line : summary) printf("%s\n", line.c_str());
+
+  return 0;
+}
@@ -0,0 +1,462 @@
+// Writes a deterministic, size-graded OpenEXR corpus for benchmarking the
+// openexr_fuzz_* harnesses.
+//
+// Every compression is combined with scanline (HALF/FLOAT/UINT), tiled
+// (ONE/MIPMAP/RIPMAP), multipart and, where the format allows it, deep
+// scanline and deep tiled images. Pixel data comes from a fixed PRNG seeded by
+// the file name, so the same invocation writes the same pixels on any machine.
+// Files are only byte-identical for NONE, RLE, B44 and B44A: the output of
+// ZIP, ZIPS, PXR24, DWAA and DWAB depends on the zlib build, and PIZ is not
+// promised either.
+//
+// Usage: openexr_corpus_generator <output_dir> [small|medium|4k]...
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <exception>
+#include <string>
+#include <vector>
+
+#include <ImfChannelList.h>
+#include <ImfDeepFrameBuffer.h>
+#include <ImfDeepScanLineOutputFile.h>
+#include <ImfDeepTiledOutputFile.h>
+#include <ImfFrameBuffer.h>
+#include <ImfHeader.h>
+#include <ImfMultiPartOutputFile.h>
+#include <ImfOutputFile.h>
+#include <ImfOutputPart.h>
+#include <ImfPartType.h>
+#include <ImfTileDescription.h>
+#include <ImfTiledOutputFile.h>
+#include <ImfTiledOutputPart.h>
+#include <half.h>
+
+#include "bench_utils.h"
+
+using namespace OPENEXR_IMF_INTERNAL_NAMESPACE;
+
+namespace {
+
+struct SizeClass {
+  const char *name;
+  int width;
+  int height;
+};
+
+const SizeClass kSizes[] = {
+    {"small", 64, 64},
+    {"medium", 512, 512},
+    {"4k", 3840, 2160},
+};
+
+struct CompressionEntry {
+  Compression compression;
+  bool deep;  // Deep images only support NONE, RLE, ZIPS and ZIP.
+};
+
+// File names use bench_exr_compression_name(), which the benchmarks share.
+const CompressionEntry kCompressions[] = {
+    {NO_COMPRESSION, true},    {RLE_COMPRESSION, true},
+    {ZIPS_COMPRESSION, true},  {ZIP_COMPRESSION, true},
+    {PIZ_COMPRESSION, false},  {PXR24_COMPRESSION, false},
+    {B44_COMPRESSION, false},  {B44A_COMPRESSION, false},
+    {DWAA_COMPRESSION, false}, {DWAB_COMPRESSION, false},
+};
+
+struct PixelTypeEntry {
+  PixelType type;
+  const char *name;
+};
+
+const PixelTypeEntry kPixelTypes[] = {
+    {HALF, "half"}, {FLOAT, "float"}, {UINT, "uint"},
+};
+
+struct LevelModeEntry {
+  LevelMode mode;
+  const char *name;
+};
+
+const LevelModeEntry kLevelModes[] = {
+    {ONE_LEVEL, "one"}, {MIPMAP_LEVELS, "mipmap"}, {RIPMAP_LEVELS, "ripmap"},
+};
+
+const char *kChannels[] = {"R", "G", "B", "A"};
+const int kChannelCount = sizeof(kChannels) / sizeof(kChannels[0]);
+
+const int kTileSize = 64;
+const int kMaxDeepSamples = 3;
+
+// xorshift32. std:: distributions are implementation defined, so the generator
+// output is only ever used through explicit integer arithmetic.
+class Random {
+ public:
+  explicit Random(uint32_t seed) : state_(seed ? seed : 0x9e3779b9u) {}
+
+  uint32_t next() {
+    state_ ^= state_ << 13;
+    state_ ^= state_ >> 17;
+    state_ ^= state_ << 5;
+    return state_;
+  }
+
+  // Uniform in [0, 1) with 8 bits of resolution.
+  float nextUnit() { return (next() >> 24) / 256.0f; }
+
+ private:
+  uint32_t state_;
+};
+
+// FNV-1a, used to derive a per-file seed from the file name. Only the base
+// name is hashed, so the contents do not depend on the output directory.
+uint32_t seedFor(const std::string &path) {
+  size_t slash = path.rfind('/');
+  const std::string name =
+      slash == std::string::npos ? path : path.substr(slash + 1);
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; i < name.size(); i++) {
+    hash ^= (unsigned char)name[i];
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+// A smooth gradient with a little noise, so that the codecs see something
+// closer to rendered images than to white noise or flat color.
+float sampleValue(int x, int y, int c, int width, int height, Random *rng) {
+  float gradient = (float)(x + (c + 1) * y) / (float)(width + 4 * height);
+  return gradient + rng->nextUnit() * 0.1f;
+}
+
+size_t pixelTypeSize(PixelType type) {
+  return type == HALF ? sizeof(half) : sizeof(float);
+}
+
+void storeSample(PixelType type, float value, char *dst) {
+  switch (type) {
+    case HALF:
+      *(half *)dst = half(value);
+      break;
+    case FLOAT:
+      *(float *)dst = value;
+      break;
+    case UINT:
+      *(unsigned int *)dst = (unsigned int)(value * 65535.0f);
+      break;
+    default:
+      break;
+  }
+}
+
+// Planar RGBA storage for one flat image level.
+class FlatImage {
+ public:
+  FlatImage(int width, int height, PixelType type, Random *rng)
+      : width_(width), type_(type) {
+    size_t size = pixelTypeSize(type);
+    for (int c = 0; c < kChannelCount; c++) {
+      planes_[c].resize((size_t)width * height * size);
+    }
+    for (int y = 0; y < height; y++) {
+      for (int x = 0; x < width; x++) {
+        size_t offset = ((size_t)y * width + x) * size;
+        for (int c = 0; c < kChannelCount; c++) {
+          storeSample(type, sampleValue(x, y, c, width, height, rng),
+                      &planes_[c][offset]);
+        }
+      }
+    }
+  }
+
+  // The image is addressed with its origin at (0, 0), which is where every
+  // level of every file in this corpus starts.
+  FrameBuffer frameBuffer() {
+    size_t size = pixelTypeSize(type_);
+    FrameBuffer fb;
+    for (int c = 0; c < kChannelCount; c++) {
+      fb.insert(kChannels[c],
+                Slice(type_, &planes_[c][0], size, size * width_));
+    }
+    return fb;
+  }
+
+ private:
+  int width_;
+  PixelType type_;
+  std::vector<char> planes_[kChannelCount];
+};
+
+// Deep storage for one image level: one contiguous sample array per channel
+// and per-pixel pointers into it. Channel 0 is "Z" (increasing per sample),
+// channel 1 is "A".
+class DeepImage {
+ public:
+  DeepImage(int width, int height, Random *rng)
+      : width_(width), counts_((size_t)width * height) {
+    size_t total = 0;
+    for (size_t i = 0; i < counts_.size(); i++) {
+      counts_[i] = rng->next() % (kMaxDeepSamples + 1);
+      total += counts_[i];
+    }
+
+    for (int c = 0; c < 2; c++) {
+      samples_[c].resize(total);
+      pointers_[c].resize(counts_.size());
+    }
+
+    size_t offset = 0;
+    for (size_t i = 0; i < counts_.size(); i++) {
+      float depth = 1.0f + rng->nextUnit();
+      for (unsigned int s = 0; s < counts_[i]; s++) {
+        samples_[0][offset + s] = depth;
+        samples_[1][offset + s] = 0.1f + rng->nextUnit() * 0.5f;
+        depth += 0.5f + rng->nextUnit();
+      }
+      for (int c = 0; c < 2; c++) {
+        pointers_[c][i] = samples_[c].data() + offset;
+      }
+      offset += counts_[i];
+    }
+  }
+
+  DeepFrameBuffer frameBuffer() {
+    DeepFrameBuffer fb;
+    fb.insertSampleCountSlice(Slice(UINT, (char *)&counts_[0],
+                                    sizeof(unsigned int),
+                                    sizeof(unsigned int) * width_));
+    fb.insert("Z", DeepSlice(FLOAT, (char *)&pointers_[0][0], sizeof(float *),
+                             sizeof(float *) * width_, sizeof(float)));
+    fb.insert("A", DeepSlice(FLOAT, (char *)&pointers_[1][0], sizeof(float *),
+                             sizeof(float *) * width_, sizeof(float)));
+    return fb;
+  }
+
+ private:
+  int width_;
+  std::vector<unsigned int> counts_;
+  std::vector<float> samples_[2];
+  std::vector<float *> pointers_[2];
+};
+
+Header flatHeader(const SizeClass &size, Compression compression,
+                  PixelType type) {
+  Header header(size.width, size.height);
+  header.compression() = compression;
+  for (int c = 0; c < kChannelCount; c++) {
+    header.channels().insert(kChannels[c], Channel(type));
+  }
+  return header;
+}
+
+Header deepHeader(const SizeClass &size, Compression compression) {
+  Header header(size.width, size.height);
+  header.compression() = compression;
+  header.channels().insert("Z", Channel(FLOAT));
+  header.channels().insert("A", Channel(FLOAT));
+  return header;
+}
+
+// Calls fn(lx, ly) for every level that exists in the given level mode.
+template <typename T, typename Fn>
+void forEachLevel(T *file, LevelMode mode, Fn fn) {
+  if (mode == RIPMAP_LEVELS) {
+    for (int ly = 0; ly < file->numYLevels(); ly++) {
+      for (int lx = 0; lx < file->numXLevels(); lx++) fn(lx, ly);
+    }
+  } else {
+    for (int l = 0; l < file->numXLevels(); l++) fn(l, l);
+  }
+}
+
+void writeScanline(const std::string &path, const SizeClass &size,
+                   Compression compression, PixelType type) {
+  Random rng(seedFor(path));
+  FlatImage image(size.width, size.height, type, &rng);
+
+  OutputFile file(path.c_str(), flatHeader(size, compression, type));
+  file.setFrameBuffer(image.frameBuffer());
+  file.writePixels(size.height);
+}
+
+void writeTiled(const std::string &path, const SizeClass &size,
+                Compression compression, LevelMode mode) {
+  Random rng(seedFor(path));
+
+  Header header = flatHeader(size, compression, HALF);
+  header.setTileDescription(TileDescription(kTileSize, kTileSize, mode));
+
+  TiledOutputFile file(path.c_str(), header);
+  forEachLevel(&file, mode, [&](int lx, int ly) {
+    FlatImage image(file.levelWidth(lx), file.levelHeight(ly), HALF, &rng);
+    file.setFrameBuffer(image.frameBuffer());
+    file.writeTiles(0, file.numXTiles(lx) - 1, 0, file.numYTiles(ly) - 1, lx,
+                    ly);
+  });
+}
+
+void writeDeepScanline(const std::string &path, const SizeClass &size,
+                       Compression compression) {
+  Random rng(seedFor(path));
+  DeepImage image(size.width, size.height, &rng);
+
+  Header header = deepHeader(size, compression);
+  header.setType(DEEPSCANLINE);
+
+  DeepScanLineOutputFile file(path.c_str(), header);
+  file.setFrameBuffer(image.frameBuffer());
+  file.writePixels(size.height);
+}
+
+void writeDeepTiled(const std::string &path, const SizeClass &size,
+                    Compression compression, LevelMode mode) {
+  Random rng(seedFor(path));
+
+  Header header = deepHeader(size, compression);
+  header.setType(DEEPTILE);
+  header.setTileDescription(TileDescription(kTileSize, kTileSize, mode));
+
+  DeepTiledOutputFile file(path.c_str(), header);
+  forEachLevel(&file, mode, [&](int lx, int ly) {
+    DeepImage image(file.levelWidth(lx), file.levelHeight(ly), &rng);
+    file.setFrameBuffer(image.frameBuffer());
+    file.writeTiles(0, file.numXTiles(lx) - 1, 0, file.numYTiles(ly) - 1, lx,
+                    ly);
+  });
+}
+
+// A compositor-style file: several scanline AOV parts plus one tiled part.
+void writeMultiPart(const std::string &path, const SizeClass &size,
+                    Compression compression) {
+  static const char *kPartNames[] = {"beauty", "diffuse", "specular",
+                                     "emission", "texture"};
+  const int partCount = sizeof(kPartNames) / sizeof(kPartNames[0]);
+  const int tiledPart = partCount - 1;
+
+  Random rng(seedFor(path));
+
+  std::vector<Header> headers;
+  for (int p = 0; p < partCount; p++) {
+    Header header = flatHeader(size, compression, HALF);
+    header.setName(kPartNames[p]);
+    if (p == tiledPart) {
+      header.setType(TILEDIMAGE);
+      header.setTileDescription(TileDescription(kTileSize, kTileSize));
+    } else {
+      header.setType(SCANLINEIMAGE);
+    }
+    headers.push_back(header);
+  }
+
+  MultiPartOutputFile file(path.c_str(), &headers[0], partCount);
+  for (int p = 0; p < partCount; p++) {
+    FlatImage image(size.width, size.height, HALF, &rng);
+    if (p == tiledPart) {
+      TiledOutputPart part(file, p);
+      part.setFrameBuffer(image.frameBuffer());
+      part.writeTiles(0, part.numXTiles() - 1, 0, part.numYTiles() - 1);
+    } else {
+      OutputPart part(file, p);
+      part.setFrameBuffer(image.frameBuffer());
+      part.writePixels(size.height);
+    }
+  }
+}
+
+std::string corpusPath(const std::string &dir, const std::string &kind,
+                       const CompressionEntry &compression,
+                       const SizeClass &size) {
+  return dir + "/" + kind + "_" +
+         bench_exr_compression_name(compression.compression) + "_" +
+         size.name + ".exr";
+}
+
+// Runs one writer, reporting (but not propagating) library errors.
+template <typename Fn>
+bool generate(const std::string &path, Fn fn) {
+  try {
+    fn(path);
+  } catch (const std::exception &e) {
+    fprintf(stderr, "%s: %s\n", path.c_str(), e.what());
+    return false;
+  }
+  printf("%s\n", path.c_str());
+  return true;
+}
+
+bool generateSize(const std::string &dir, const SizeClass &size) {
+  bool ok = true;
+  for (const CompressionEntry &c : kCompressions) {
+    for (const PixelTypeEntry &t : kPixelTypes) {
+      ok &= generate(
+          corpusPath(dir, std::string("scanline_") + t.name, c, size),
+          [&](const std::string &path) {
+            writeScanline(path, size, c.compression, t.type);
+          });
+    }
+
+    for (const LevelModeEntry &m : kLevelModes) {
+      ok &= generate(corpusPath(dir, std::string("tiled_") + m.name, c, size),
+                     [&](const std::string &path) {
+                       writeTiled(path, size, c.compression, m.mode);
+                     });
+    }
+
+    ok &= generate(corpusPath(dir, "multipart", c, size),
+                   [&](const std::string &path) {
+                     writeMultiPart(path, size, c.compression);
+                   });
+
+    if (!c.deep) continue;
+
+    ok &= generate(corpusPath(dir, "deepscanline", c, size),
+                   [&](const std::string &path) {
+                     writeDeepScanline(path, size, c.compression);
+                   });
+
+    for (const LevelModeEntry &m : kLevelModes) {
+      ok &= generate(
+          corpusPath(dir, std::string("deeptiled_") + m.name, c, size),
+          [&](const std::string &path) {
+            writeDeepTiled(path, size, c.compression, m.mode);
+          });
+    }
+  }
+  return ok;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    fprintf(stderr, "usage: %s <output_dir> [small|medium|4k]...\n", argv[0]);
+    return 1;
+  }
+
+  for (int i = 2; i < argc; i++) {
+    bool known = false;
+    for (const SizeClass &size : kSizes) {
+      if (strcmp(argv[i], size.name) == 0) known = true;
+    }
+    if (!known) {
+      fprintf(stderr, "%s: unknown size \"%s\"\n", argv[0], argv[i]);
+      fprintf(stderr, "usage: %s <output_dir> [small|medium|4k]...\n",
+              argv[0]);
+      return 1;
+    }
+  }
+
+  const std::string dir = argv[1];
+  bool ok = true;
+  for (const SizeClass &size : kSizes) {
+    bool selected = argc == 2;
+    for (int i = 2; i < argc; i++) {
+      if (strcmp(argv[i], size.name) == 0) selected = true;
+    }
+    if (selected) ok &= generateSize(dir, size);
+  }
+
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,278 @@
+// Deep OpenEXR layout and compositing benchmark.
+//
+// Compares two ways of sizing deep sample storage after
+// readPixelSampleCounts():
+//   - per pixel: one allocation per pixel and channel, as
+//     openexr_fuzz_deepscanlines does;
+//   - contiguous: a prefix sum over the sample counts and one buffer per
+//     channel, as openexr_fuzz_deeptiles does.
+// It then flattens the contiguous samples front to back with "over" using the
+// A channel, which is the access pattern of a deep compositing step.
+//
+// Every deep part of each file is read (level 0 for tiled parts), with all
+// channels converted to FLOAT.
+//
+// Usage: openexr_deep_benchmark [-r repeats] file.exr...
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <exception>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <ImfArray.h>
+#include <ImfChannelList.h>
+#include <ImfDeepFrameBuffer.h>
+#include <ImfDeepScanLineInputPart.h>
+#include <ImfDeepTiledInputPart.h>
+#include <ImfHeader.h>
+#include <ImfMultiPartInputFile.h>
+#include <ImfPartType.h>
+#include <ImfThreading.h>
+
+#include "bench_utils.h"
+
+namespace IMF = OPENEXR_IMF_NAMESPACE;
+using namespace IMF;
+using IMATH_NAMESPACE::Box2i;
+
+namespace {
+
+struct Stats {
+  double samples = 0;
+  double perPixelSeconds = 0;
+  double contiguousSeconds = 0;
+  double flattenSeconds = 0;
+};
+
+// Deep storage for the data window of one part.
+struct DeepBuffers {
+  int width;
+  int height;
+  std::vector<std::string> names;
+  Array2D<unsigned int> counts;
+  Array<Array2D<float *> > pointers;
+  Array<std::vector<float> > samples;  // Only used by the contiguous layout.
+  // Only used by the per-pixel layout. Owning the arrays here frees them
+  // even when a read throws.
+  std::vector<std::unique_ptr<float[]> > perPixel;
+
+  explicit DeepBuffers(const Header &header) {
+    const Box2i &dw = header.dataWindow();
+    width = dw.max.x - dw.min.x + 1;
+    height = dw.max.y - dw.min.y + 1;
+
+    for (ChannelList::ConstIterator i = header.channels().begin();
+         i != header.channels().end(); ++i) {
+      names.push_back(i.name());
+    }
+
+    counts.resizeErase(height, width);
+    pointers.resizeErase(names.size());
+    samples.resizeErase(names.size());
+    for (size_t k = 0; k < names.size(); k++) {
+      pointers[k].resizeErase(height, width);
+    }
+  }
+
+  DeepFrameBuffer frameBuffer(const Box2i &dw) {
+    int memOffset = dw.min.x + dw.min.y * width;
+
+    DeepFrameBuffer frameBuffer;
+    frameBuffer.insertSampleCountSlice(
+        Slice(IMF::UINT, (char *)(&counts[0][0] - memOffset),
+              sizeof(unsigned int), sizeof(unsigned int) * width));
+    for (size_t k = 0; k < names.size(); k++) {
+      frameBuffer.insert(
+          names[k],
+          DeepSlice(IMF::FLOAT, (char *)(&pointers[k][0][0] - memOffset),
+                    sizeof(float *), sizeof(float *) * width, sizeof(float)));
+    }
+    return frameBuffer;
+  }
+
+  uint64_t totalSamples() const {
+    uint64_t total = 0;
+    for (int y = 0; y < height; y++)
+      for (int x = 0; x < width; x++) total += counts[y][x];
+    return total;
+  }
+};
+
+void readCounts(DeepScanLineInputPart *part) {
+  const Box2i &dw = part->header().dataWindow();
+  part->readPixelSampleCounts(dw.min.y, dw.max.y);
+}
+
+void readSamples(DeepScanLineInputPart *part) {
+  const Box2i &dw = part->header().dataWindow();
+  part->readPixels(dw.min.y, dw.max.y);
+}
+
+void readCounts(DeepTiledInputPart *part) {
+  part->readPixelSampleCounts(0, part->numXTiles(0) - 1, 0,
+                              part->numYTiles(0) - 1, 0, 0);
+}
+
+void readSamples(DeepTiledInputPart *part) {
+  part->readTiles(0, part->numXTiles(0) - 1, 0, part->numYTiles(0) - 1, 0, 0);
+}
+
+template <typename T>
+void readPerPixel(T *part, DeepBuffers *buffers) {
+  readCounts(part);
+  buffers->perPixel.clear();
+  for (size_t k = 0; k < buffers->names.size(); k++) {
+    for (int y = 0; y < buffers->height; y++) {
+      for (int x = 0; x < buffers->width; x++) {
+        float *pixel = new float[buffers->counts[y][x]];
+        buffers->perPixel.emplace_back(pixel);
+        buffers->pointers[k][y][x] = pixel;
+      }
+    }
+  }
+
+  readSamples(part);
+  buffers->perPixel.clear();
+}
+
+template <typename T>
+void readContiguous(T *part, DeepBuffers *buffers) {
+  readCounts(part);
+
+  uint64_t total = buffers->totalSamples();
+  for (size_t k = 0; k < buffers->names.size(); k++) {
+    buffers->samples[k].resize(total);
+  }
+
+  uint64_t offset = 0;
+  for (int y = 0; y < buffers->height; y++) {
+    for (int x = 0; x < buffers->width; x++) {
+      for (size_t k = 0; k < buffers->names.size(); k++) {
+        buffers->pointers[k][y][x] = buffers->samples[k].data() + offset;
+      }
+      offset += buffers->counts[y][x];
+    }
+  }
+
+  readSamples(part);
+}
+
+// Composites each pixel's samples front to back, in stored order, into one
+// flat value per channel. Without an A channel the samples are summed.
+void flatten(const DeepBuffers &buffers, std::vector<float> *flat) {
+  const size_t channelCount = buffers.names.size();
+  int alphaChannel = -1;
+  for (size_t k = 0; k < channelCount; k++) {
+    if (buffers.names[k] == "A") alphaChannel = k;
+  }
+
+  flat->assign((size_t)buffers.width * buffers.height * channelCount, 0.0f);
+  float *out = flat->data();
+  uint64_t offset = 0;
+  for (int y = 0; y < buffers.height; y++) {
+    for (int x = 0; x < buffers.width; x++, out += channelCount) {
+      unsigned int count = buffers.counts[y][x];
+      float alpha = 0;
+      for (unsigned int s = 0; s < count; s++) {
+        float weight = 1.0f - alpha;
+        for (size_t k = 0; k < channelCount; k++) {
+          out[k] += weight * buffers.samples[k][offset + s];
+        }
+        if (alphaChannel >= 0) {
+          alpha += weight * buffers.samples[alphaChannel][offset + s];
+          if (alpha >= 1.0f) break;
+        }
+      }
+      offset += count;
+    }
+  }
+}
+
+// Adds to *s only once every read of the part has succeeded.
+template <typename T>
+void benchmarkPart(MultiPartInputFile *file, int p, int repeats, Stats *s) {
+  T part(*file, p);
+  DeepBuffers buffers(part.header());
+  part.setFrameBuffer(buffers.frameBuffer(part.header().dataWindow()));
+
+  // Untimed, so that neither layout pays for the first read of the file
+  // and the first touch of its pages.
+  readPerPixel(&part, &buffers);
+  readContiguous(&part, &buffers);
+
+  Stats partStats;
+  double start = bench_now();
+  for (int r = 0; r < repeats; r++) readPerPixel(&part, &buffers);
+  partStats.perPixelSeconds = bench_now() - start;
+
+  start = bench_now();
+  for (int r = 0; r < repeats; r++) readContiguous(&part, &buffers);
+  partStats.contiguousSeconds = bench_now() - start;
+
+  std::vector<float> flat;
+  start = bench_now();
+  for (int r = 0; r < repeats; r++) flatten(buffers, &flat);
+  partStats.flattenSeconds = bench_now() - start;
+
+  s->samples += (double)buffers.totalSamples() * repeats;
+  s->perPixelSeconds += partStats.perPixelSeconds;
+  s->contiguousSeconds += partStats.contiguousSeconds;
+  s->flattenSeconds += partStats.flattenSeconds;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  int repeats = 3;
+  int opt;
+  while ((opt = getopt(argc, argv, "r:")) != -1) {
+    switch (opt) {
+      case 'r':
+        repeats = atoi(optarg);
+        break;
+      default:
+        fprintf(stderr, "usage: %s [-r repeats] file.exr...\n", argv[0]);
+        return 1;
+    }
+  }
+  if (repeats < 1) repeats = 1;
+  setGlobalThreadCount(0);
+
+  Stats s;
+  for (int i = optind; i < argc; i++) {
+    const char *fileName = argv[i];
+    try {
+      MultiPartInputFile file(fileName, 0);
+      for (int p = 0; p < file.parts(); p++) {
+        const Header &header = file.header(p);
+        if (!header.hasType()) continue;
+        try {
+          if (header.type() == DEEPTILE) {
+            benchmarkPart<DeepTiledInputPart>(&file, p, repeats, &s);
+          } else if (header.type() == DEEPSCANLINE) {
+            benchmarkPart<DeepScanLineInputPart>(&file, p, repeats, &s);
+          }
+        } catch (const std::exception &e) {
+          fprintf(stderr, "%s: part %d skipped: %s\n", fileName, p, e.what());
+        }
+      }
+    } catch (const std::exception &e) {
+      fprintf(stderr, "%s: skipped: %s\n", fileName, e.what());
+    }
+  }
+
+  printf("samples: %.0f\n", s.samples);
+  printf("%-12s %14s\n", "phase", "Msamples/s");
+  printf("%-12s %14.2f\n", "per-pixel",
+         s.perPixelSeconds > 0 ? s.samples / s.perPixelSeconds / 1e6 : 0);
+  printf("%-12s %14.2f\n", "contiguous",
+         s.contiguousSeconds > 0 ? s.samples / s.contiguousSeconds / 1e6 : 0);
+  printf("%-12s %14.2f\n", "flatten",
+         s.flattenSeconds > 0 ? s.samples / s.flattenSeconds / 1e6 : 0);
+  return 0;
+}
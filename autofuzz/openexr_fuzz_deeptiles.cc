@@ -4,6 +4,8 @@
 #include <string.h>
 #include <unistd.h>
 
+#include <vector>
+
 #include <ImfArray.h>
 #include <ImfChannelList.h>
 #include <ImfDeepTiledInputFile.h>
@@ -16,6 +18,11 @@ using IMATH_NAMESPACE::Box2i;
 
 namespace {
 
+// Levels whose samples, summed over every channel, add up to more than this
+// are skipped, so that a few huge counts or many channels cannot exhaust
+// memory.
+const uint64_t kMaxSamplesPerLevel = 1 << 26;
+
 template <typename T>
 static void readFile(T *part) {
   const Header &fileHeader = part->header();
@@ -61,26 +68,39 @@ static void readFile(T *part) {
                        pointerSize * 1, pointerSize * width, sampleSize));
   }
 
+  // One contiguous sample buffer per channel, reused across levels.
+  Array<std::vector<float> > samples(channelCount);
+
   part->setFrameBuffer(frameBuffer);
   for (int ly = 0; ly < part->numYLevels(); ly++) {
     for (int lx = 0; lx < part->numXLevels(); lx++) {
-      Box2i dataWindowL = part->dataWindowForLevel(lx, ly);
+      int levelHeight = part->levelHeight(ly);
+      int levelWidth = part->levelWidth(lx);
 
       part->readPixelSampleCounts(0, part->numXTiles(lx) - 1, 0,
                                   part->numYTiles(ly) - 1, lx, ly);
 
-      for (int i = 0; i < part->numYTiles(ly); i++) {
-        for (int j = 0; j < part->numXTiles(lx); j++) {
-          Box2i box = part->dataWindowForTile(j, i, lx, ly);
-          for (int y = box.min.y; y <= box.max.y; y++)
-            for (int x = box.min.x; x <= box.max.x; x++) {
-              int dwy = y - dataWindowL.min.y;
-              int dwx = x - dataWindowL.min.x;
-
-              for (int k = 0; k < channelCount; k++) {
-                data[k][dwy][dwx] = new float[localSampleCount[dwy][dwx]];
-              }
-            }
+      uint64_t totalSamples = 0;
+      for (int y = 0; y < levelHeight; y++)
+        for (int x = 0; x < levelWidth; x++)
+          totalSamples += localSampleCount[y][x];
+
+      if (channelCount > 0 &&
+          totalSamples > kMaxSamplesPerLevel / channelCount) {
+        continue;
+      }
+
+      for (int k = 0; k < channelCount; k++) samples[k].resize(totalSamples);
+
+      // Prefix sum of the sample counts: each pixel's samples start where the
+      // previous pixel's end, in scanline order.
+      uint64_t offset = 0;
+      for (int y = 0; y < levelHeight; y++) {
+        for (int x = 0; x < levelWidth; x++) {
+          for (int k = 0; k < channelCount; k++) {
+            data[k][y][x] = samples[k].data() + offset;
+          }
+          offset += localSampleCount[y][x];
         }
       }
 
@@ -89,14 +109,6 @@ static void readFile(T *part) {
                         lx, ly);
       } catch (...) {
       }
-
-      for (int i = 0; i < part->levelHeight(ly); i++) {
-        for (int j = 0; j < part->levelWidth(lx); j++) {
-          for (int k = 0; k < channelCount; k++) {
-            delete[](float *) data[k][i][j];
-          }
-        }
-      }
     }
   }
 }
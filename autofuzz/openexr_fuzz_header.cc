@@ -0,0 +1,37 @@
+// Parses only the OpenEXR magic number, version and header list from memory.
+// Unlike the other openexr_fuzz_* targets, no input file object is built, so
+// no offset tables are read and no line or tile buffers are allocated.
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <vector>
+
+#include <ImfHeader.h>
+
+#include "openexr_header_reader.h"
+#include "openexr_mem_stream.h"
+
+using namespace OPENEXR_IMF_INTERNAL_NAMESPACE;
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+  Header::setMaxImageSize(10000, 10000);
+  Header::setMaxTileSize(10000, 10000);
+
+  std::vector<Header> headers;
+  try {
+    MemIStream is((const char *)data, size);
+    readExrHeaders(is, &headers);
+  } catch (...) {
+  }
+
+  // Touch every attribute that was parsed, valid header or not.
+  for (size_t i = 0; i < headers.size(); i++) {
+    for (Header::ConstIterator a = headers[i].begin(); a != headers[i].end();
+         ++a) {
+      a.attribute().typeName();
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,99 @@
+// Header parsing throughput benchmark for the openexr_fuzz_header path.
+//
+// Every file is loaded into memory once. Its header list is then parsed from
+// an in-memory stream, and for comparison a full MultiPartInputFile is opened
+// on the same bytes, which also reads the chunk offset tables.
+//
+// Usage: openexr_header_benchmark [-r repeats] file.exr...
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <exception>
+#include <string>
+#include <vector>
+
+#include <ImfHeader.h>
+#include <ImfMultiPartInputFile.h>
+#include <ImfThreading.h>
+
+#include "bench_utils.h"
+#include "openexr_header_reader.h"
+#include "openexr_mem_stream.h"
+
+using namespace OPENEXR_IMF_INTERNAL_NAMESPACE;
+
+namespace {
+
+// Return the number of headers read, through the same readExrHeaders() as
+// openexr_fuzz_header, sanity checks included.
+size_t readHeaders(const std::string &data) {
+  MemIStream is(data.data(), data.size());
+  std::vector<Header> headers;
+  readExrHeaders(is, &headers);
+  return headers.size();
+}
+
+size_t openFile(const std::string &data) {
+  MemIStream is(data.data(), data.size());
+  MultiPartInputFile file(is, 0);
+  return file.parts();
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  int repeats = 100;
+  int opt;
+  while ((opt = getopt(argc, argv, "r:")) != -1) {
+    switch (opt) {
+      case 'r':
+        repeats = atoi(optarg);
+        break;
+      default:
+        fprintf(stderr, "usage: %s [-r repeats] file.exr...\n", argv[0]);
+        return 1;
+    }
+  }
+  if (repeats < 1) repeats = 1;
+  setGlobalThreadCount(0);
+
+  std::vector<std::string> files;
+  for (int i = optind; i < argc; i++) {
+    files.resize(files.size() + 1);
+    if (bench_read_file(argv[i], &files.back()) != 0) files.pop_back();
+  }
+
+  size_t headers = 0;
+  double start = bench_now();
+  for (int r = 0; r < repeats; r++) {
+    for (const std::string &data : files) {
+      try {
+        headers += readHeaders(data);
+      } catch (const std::exception &e) {
+      }
+    }
+  }
+  double headerSeconds = bench_now() - start;
+
+  size_t parts = 0;
+  start = bench_now();
+  for (int r = 0; r < repeats; r++) {
+    for (const std::string &data : files) {
+      try {
+        parts += openFile(data);
+      } catch (const std::exception &e) {
+      }
+    }
+  }
+  double openSeconds = bench_now() - start;
+
+  printf("files: %zu, repeats: %d\n", files.size(), repeats);
+  printf("%-14s %10s %14s\n", "mode", "headers", "headers/sec");
+  printf("%-14s %10zu %14.0f\n", "header only", headers,
+         headerSeconds > 0 ? headers / headerSeconds : 0);
+  printf("%-14s %10zu %14.0f\n", "full open", parts,
+         openSeconds > 0 ? parts / openSeconds : 0);
+  return 0;
+}
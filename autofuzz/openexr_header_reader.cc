@@ -0,0 +1,28 @@
+#include "openexr_header_reader.h"
+
+#include <ImfVersion.h>
+#include <ImfXdr.h>
+
+using namespace OPENEXR_IMF_INTERNAL_NAMESPACE;
+
+void readExrHeaders(IStream &is, std::vector<Header> *headers) {
+  int magic;
+  int version;
+  Xdr::read<StreamIO>(is, magic);
+  Xdr::read<StreamIO>(is, version);
+  if (magic != MAGIC) return;
+
+  bool multiPart = isMultiPart(version);
+  do {
+    headers->resize(headers->size() + 1);
+    headers->back().readFrom(is, version);
+    if (headers->back().readsNothing()) {
+      headers->pop_back();
+      break;
+    }
+  } while (multiPart);
+
+  for (size_t i = 0; i < headers->size(); i++) {
+    (*headers)[i].sanityCheck(isTiled(version), multiPart);
+  }
+}
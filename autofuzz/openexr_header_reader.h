@@ -0,0 +1,24 @@
+// Reads the OpenEXR magic number, version and header list from a stream,
+// without building an input file object. Shared by openexr_fuzz_header and
+// openexr_header_benchmark so that both parse exactly the same way.
+
+#ifndef OPENEXR_HEADER_READER_H_
+#define OPENEXR_HEADER_READER_H_
+
+#include <vector>
+
+#include <ImfHeader.h>
+#include <ImfIO.h>
+
+// Reads the header list the way MultiPartInputFile does: one header for
+// single-part files, and headers until an empty one for multipart files.
+// Every header is then sanity checked.
+//
+// Headers are appended to *headers as they are read, so on an exception the
+// ones parsed so far are still there. Nothing is read if the magic number
+// does not match.
+void readExrHeaders(
+    OPENEXR_IMF_INTERNAL_NAMESPACE::IStream &is,
+    std::vector<OPENEXR_IMF_INTERNAL_NAMESPACE::Header> *headers);
+
+#endif  // OPENEXR_HEADER_READER_H_
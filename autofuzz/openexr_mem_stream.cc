@@ -0,0 +1,54 @@
+#include "openexr_mem_stream.h"
+
+#include <string.h>
+
+#include <Iex.h>
+
+using OPENEXR_IMF_INTERNAL_NAMESPACE::Int64;
+
+MemIStream::MemIStream(const char *data, size_t size)
+    : IStream("<memory>"), data_(data), size_(size), pos_(0) {}
+
+bool MemIStream::isMemoryMapped() const { return true; }
+
+void MemIStream::checkAvailable(int n) const {
+  if (n < 0 || pos_ > size_ || (size_t)n > size_ - pos_) {
+    throw IEX_NAMESPACE::InputExc("Unexpected end of file.");
+  }
+}
+
+bool MemIStream::read(char c[], int n) {
+  checkAvailable(n);
+  memcpy(c, data_ + pos_, n);
+  pos_ += n;
+  return pos_ < size_;
+}
+
+char *MemIStream::readMemoryMapped(int n) {
+  checkAvailable(n);
+  char *data = const_cast<char *>(data_ + pos_);
+  pos_ += n;
+  return data;
+}
+
+Int64 MemIStream::tellg() { return pos_; }
+
+// Seeking past the end is allowed; the next read fails instead.
+void MemIStream::seekg(Int64 pos) { pos_ = pos; }
+
+MemOStream::MemOStream(std::string *buf)
+    : OStream("<memory>"), buf_(buf), pos_(0) {
+  buf_->clear();
+}
+
+void MemOStream::write(const char c[], int n) {
+  if (pos_ + n > buf_->size()) {
+    buf_->resize(pos_ + n);
+  }
+  memcpy(&(*buf_)[pos_], c, n);
+  pos_ += n;
+}
+
+Int64 MemOStream::tellp() { return pos_; }
+
+void MemOStream::seekp(Int64 pos) { pos_ = pos; }
@@ -0,0 +1,49 @@
+// In-memory Imf::IStream and Imf::OStream for the OpenEXR fuzz targets and
+// benchmarks, so that files can be read and written without a temporary file.
+
+#ifndef OPENEXR_MEM_STREAM_H_
+#define OPENEXR_MEM_STREAM_H_
+
+#include <stddef.h>
+
+#include <string>
+
+#include <ImfIO.h>
+#include <ImfInt64.h>
+
+// Reads from a caller-owned buffer, which must outlive the stream.
+class MemIStream : public OPENEXR_IMF_INTERNAL_NAMESPACE::IStream {
+ public:
+  MemIStream(const char *data, size_t size);
+
+  bool isMemoryMapped() const;
+  bool read(char c[], int n);
+  char *readMemoryMapped(int n);
+  OPENEXR_IMF_INTERNAL_NAMESPACE::Int64 tellg();
+  void seekg(OPENEXR_IMF_INTERNAL_NAMESPACE::Int64 pos);
+
+ private:
+  // Throws Iex::InputExc if fewer than n bytes are left.
+  void checkAvailable(int n) const;
+
+  const char *data_;
+  size_t size_;
+  size_t pos_;
+};
+
+// Writes into a caller-owned string. The string is cleared but keeps its
+// capacity, so reusing one string across streams avoids reallocating.
+class MemOStream : public OPENEXR_IMF_INTERNAL_NAMESPACE::OStream {
+ public:
+  explicit MemOStream(std::string *buf);
+
+  void write(const char c[], int n);
+  OPENEXR_IMF_INTERNAL_NAMESPACE::Int64 tellp();
+  void seekp(OPENEXR_IMF_INTERNAL_NAMESPACE::Int64 pos);
+
+ private:
+  std::string *buf_;
+  size_t pos_;
+};
+
+#endif  // OPENEXR_MEM_STREAM_H_
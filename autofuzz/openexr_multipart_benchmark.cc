@@ -0,0 +1,206 @@
+// Benchmark for decoding the parts of a multipart OpenEXR file concurrently.
+//
+// Every flat part is decoded into its own RGBA frame buffer, as readMulti()
+// and readImageONE2() do in the fuzz targets: first serially, then with the
+// parts spread over a pool of worker threads.
+//
+// In the "shared" run the workers share one MultiPartInputFile, as the fuzz
+// targets do. OpenEXR holds the file's stream lock for the whole of
+// readPixels() and readTiles(), decompression included, so these workers
+// are serialized and the run shows the cost of sharing the stream rather
+// than any parallel decode. In the "own" run every worker opens its own
+// MultiPartInputFile on the file, which is what lets parts decompress in
+// parallel; the extra opens are timed too.
+//
+// Usage: openexr_multipart_benchmark [-j workers] [-t threads] [-r repeats]
+//            file.exr...
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <ImfArray.h>
+#include <ImfFrameBuffer.h>
+#include <ImfHeader.h>
+#include <ImfInputPart.h>
+#include <ImfMultiPartInputFile.h>
+#include <ImfPartType.h>
+#include <ImfRgba.h>
+#include <ImfThreading.h>
+#include <ImfTiledInputPart.h>
+
+#include "bench_utils.h"
+
+using namespace OPENEXR_IMF_INTERNAL_NAMESPACE;
+using IMATH_NAMESPACE::Box2i;
+
+namespace {
+
+// Decodes part p into a frame buffer owned by the caller's thread.
+//
+// Return the number of bytes decoded, 0 if the part was skipped or failed.
+double decodePart(MultiPartInputFile *file, int p) {
+  try {
+    const Header &header = file->header(p);
+    if (header.hasType() && isDeepData(header.type())) return 0;
+
+    bool tiled = header.hasType() ? isTiled(header.type())
+                                  : header.hasTileDescription();
+
+    const Box2i &dw = header.dataWindow();
+    int w = dw.max.x - dw.min.x + 1;
+    int h = dw.max.y - dw.min.y + 1;
+    int dwx = dw.min.x;
+    int dwy = dw.min.y;
+
+    Array2D<Rgba> pixels(h, w);
+    FrameBuffer i;
+    i.insert("R", Slice(HALF, (char *)&(pixels[-dwy][-dwx].r), sizeof(Rgba),
+                        w * sizeof(Rgba)));
+    i.insert("G", Slice(HALF, (char *)&(pixels[-dwy][-dwx].g), sizeof(Rgba),
+                        w * sizeof(Rgba)));
+    i.insert("B", Slice(HALF, (char *)&(pixels[-dwy][-dwx].b), sizeof(Rgba),
+                        w * sizeof(Rgba)));
+    i.insert("A", Slice(HALF, (char *)&(pixels[-dwy][-dwx].a), sizeof(Rgba),
+                        w * sizeof(Rgba)));
+
+    if (tiled) {
+      TiledInputPart in(*file, p);
+      in.setFrameBuffer(i);
+      in.readTiles(0, in.numXTiles() - 1, 0, in.numYTiles() - 1);
+    } else {
+      InputPart in(*file, p);
+      in.setFrameBuffer(i);
+      in.readPixels(dw.min.y, dw.max.y);
+    }
+
+    return (double)w * h * sizeof(Rgba);
+  } catch (const std::exception &e) {
+    fprintf(stderr, "part %d: %s\n", p, e.what());
+    return 0;
+  }
+}
+
+double decodeSerial(const char *fileName) {
+  MultiPartInputFile file(fileName);
+  double bytes = 0;
+  for (int p = 0; p < file.parts(); p++) bytes += decodePart(&file, p);
+  return bytes;
+}
+
+// Workers pull the next part index until every part has been claimed. With
+// ownFile, each worker reads through its own MultiPartInputFile instead of
+// the shared one.
+double decodeParallel(const char *fileName, int workers, bool ownFile) {
+  MultiPartInputFile shared(fileName);
+  const int parts = shared.parts();
+
+  std::atomic<int> next(0);
+  std::vector<double> bytes(workers);
+  std::vector<std::thread> pool;
+  for (int t = 0; t < workers; t++) {
+    pool.emplace_back([&, t]() {
+      try {
+        std::unique_ptr<MultiPartInputFile> own;
+        for (int p = next++; p < parts; p = next++) {
+          if (ownFile && !own) own.reset(new MultiPartInputFile(fileName));
+          bytes[t] += decodePart(ownFile ? own.get() : &shared, p);
+        }
+      } catch (const std::exception &e) {
+        fprintf(stderr, "%s: worker %d: %s\n", fileName, t, e.what());
+      }
+    });
+  }
+
+  double total = 0;
+  for (int t = 0; t < workers; t++) {
+    pool[t].join();
+    total += bytes[t];
+  }
+  return total;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  int workers = std::thread::hardware_concurrency();
+  int threads = 0;
+  int repeats = 1;
+  int opt;
+  while ((opt = getopt(argc, argv, "j:t:r:")) != -1) {
+    switch (opt) {
+      case 'j':
+        workers = atoi(optarg);
+        break;
+      case 't':
+        threads = atoi(optarg);
+        break;
+      case 'r':
+        repeats = atoi(optarg);
+        break;
+      default:
+        fprintf(stderr,
+                "usage: %s [-j workers] [-t threads] [-r repeats] "
+                "file.exr...\n",
+                argv[0]);
+        return 1;
+    }
+  }
+  if (workers < 1) workers = 1;
+  if (repeats < 1) repeats = 1;
+  // Library threads decode line buffers or tiles within one part; keep them
+  // off by default so that the comparison isolates part-level parallelism.
+  setGlobalThreadCount(threads);
+
+  printf("%-40s %6s %10s %12s %12s %12s %8s %8s\n", "file", "parts", "MB",
+         "serial MB/s", "shared MB/s", "own MB/s", "shared", "own");
+
+  double serialTotal = 0;
+  double sharedTotal = 0;
+  double ownTotal = 0;
+  for (int i = optind; i < argc; i++) {
+    const char *fileName = argv[i];
+    try {
+      int parts = MultiPartInputFile(fileName).parts();
+
+      double bytes = 0;
+      double start = bench_now();
+      for (int r = 0; r < repeats; r++) bytes += decodeSerial(fileName);
+      double serial = bench_now() - start;
+
+      start = bench_now();
+      for (int r = 0; r < repeats; r++) {
+        decodeParallel(fileName, workers, false);
+      }
+      double shared = bench_now() - start;
+
+      start = bench_now();
+      for (int r = 0; r < repeats; r++) decodeParallel(fileName, workers, true);
+      double own = bench_now() - start;
+
+      serialTotal += serial;
+      sharedTotal += shared;
+      ownTotal += own;
+      printf("%-40s %6d %10.1f %12.1f %12.1f %12.1f %7.2fx %7.2fx\n",
+             fileName, parts, bytes / (1024.0 * 1024.0),
+             bench_mb_per_sec(bytes, serial), bench_mb_per_sec(bytes, shared),
+             bench_mb_per_sec(bytes, own), shared > 0 ? serial / shared : 0,
+             own > 0 ? serial / own : 0);
+    } catch (const std::exception &e) {
+      fprintf(stderr, "%s: skipped: %s\n", fileName, e.what());
+    }
+  }
+
+  printf(
+      "workers: %d, library threads: %d, overall speedup: %.2fx shared, "
+      "%.2fx own\n",
+      workers, threads, sharedTotal > 0 ? serialTotal / sharedTotal : 0,
+      ownTotal > 0 ? serialTotal / ownTotal : 0);
+  return 0;
+}
@@ -0,0 +1,178 @@
+// Benchmark for the openexr_fuzz_scanlines read paths.
+//
+// Decodes every file twice through RgbaInputFile: once line by line into a
+// one-row buffer, as the fuzz target does, and once with a single
+// readPixels(min.y, max.y) call over the whole data window. Throughput is
+// reported per compression and per channel type, in MB/s of uncompressed
+// channel data.
+//
+// Usage: openexr_scanlines_benchmark [-r repeats] [-t threads] file.exr...
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <exception>
+#include <map>
+#include <string>
+#include <utility>
+
+#include <ImfArray.h>
+#include <ImfChannelList.h>
+#include <ImfHeader.h>
+#include <ImfRgbaFile.h>
+#include <ImfThreading.h>
+
+#include "bench_utils.h"
+
+using namespace OPENEXR_IMF_INTERNAL_NAMESPACE;
+using IMATH_NAMESPACE::Box2i;
+
+namespace {
+
+struct Stats {
+  int files = 0;
+  double bytes = 0;
+  double lineSeconds = 0;
+  double wholeSeconds = 0;
+};
+
+const char *pixelTypeName(PixelType type) {
+  switch (type) {
+    case HALF:
+      return "half";
+    case FLOAT:
+      return "float";
+    case UINT:
+      return "uint";
+    default:
+      return "unknown";
+  }
+}
+
+// Name of the channel type shared by all channels, or "mixed".
+std::string channelTypeName(const ChannelList &channels) {
+  std::string name;
+  for (ChannelList::ConstIterator i = channels.begin(); i != channels.end();
+       ++i) {
+    const char *type = pixelTypeName(i.channel().type);
+    if (name.empty()) {
+      name = type;
+    } else if (name != type) {
+      return "mixed";
+    }
+  }
+  return name.empty() ? "none" : name;
+}
+
+// Size of the data window in the file's own channel types.
+double uncompressedBytes(const Header &header) {
+  const Box2i &dw = header.dataWindow();
+  double pixels =
+      (double)(dw.max.x - dw.min.x + 1) * (dw.max.y - dw.min.y + 1);
+
+  double bytesPerPixel = 0;
+  for (ChannelList::ConstIterator i = header.channels().begin();
+       i != header.channels().end(); ++i) {
+    bytesPerPixel += i.channel().type == HALF ? 2 : 4;
+  }
+  return pixels * bytesPerPixel;
+}
+
+// The openexr_fuzz_scanlines readSingle() path.
+void readPerLine(RgbaInputFile *in) {
+  const Box2i &dw = in->dataWindow();
+  int w = dw.max.x - dw.min.x + 1;
+  int dx = dw.min.x;
+
+  Array<Rgba> pixels(w);
+  in->setFrameBuffer(&pixels[-dx], 1, 0);
+  for (int y = dw.min.y; y <= dw.max.y; ++y) in->readPixels(y);
+}
+
+void readWhole(RgbaInputFile *in) {
+  const Box2i &dw = in->dataWindow();
+  int w = dw.max.x - dw.min.x + 1;
+  int h = dw.max.y - dw.min.y + 1;
+  int dx = dw.min.x;
+  int dy = dw.min.y;
+
+  Array2D<Rgba> pixels(h, w);
+  in->setFrameBuffer(&pixels[-dy][-dx], 1, w);
+  in->readPixels(dw.min.y, dw.max.y);
+}
+
+template <typename Fn>
+double timeRead(const char *fileName, int repeats, Fn fn) {
+  double start = bench_now();
+  for (int r = 0; r < repeats; r++) {
+    RgbaInputFile in(fileName);
+    fn(&in);
+  }
+  return bench_now() - start;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  int repeats = 3;
+  int threads = 0;
+  int opt;
+  while ((opt = getopt(argc, argv, "r:t:")) != -1) {
+    switch (opt) {
+      case 'r':
+        repeats = atoi(optarg);
+        break;
+      case 't':
+        threads = atoi(optarg);
+        break;
+      default:
+        fprintf(stderr, "usage: %s [-r repeats] [-t threads] file.exr...\n",
+                argv[0]);
+        return 1;
+    }
+  }
+  if (repeats < 1) repeats = 1;
+  setGlobalThreadCount(threads);
+
+  std::map<std::pair<std::string, std::string>, Stats> stats;
+  for (int i = optind; i < argc; i++) {
+    const char *fileName = argv[i];
+    try {
+      Header header;
+      {
+        RgbaInputFile in(fileName);
+        header = in.header();
+      }
+
+      // Only count files that read both ways, so that a file failing
+      // halfway does not add bytes without time.
+      double lineSeconds = timeRead(fileName, repeats, readPerLine);
+      double wholeSeconds = timeRead(fileName, repeats, readWhole);
+
+      Stats &s = stats[std::make_pair(
+          bench_exr_compression_name(header.compression()),
+          channelTypeName(header.channels()))];
+      s.files++;
+      s.bytes += uncompressedBytes(header) * repeats;
+      s.lineSeconds += lineSeconds;
+      s.wholeSeconds += wholeSeconds;
+    } catch (const std::exception &e) {
+      fprintf(stderr, "%s: skipped: %s\n", fileName, e.what());
+    }
+  }
+
+  printf("%-8s %-8s %6s %10s %14s %14s %8s\n", "codec", "channels", "files",
+         "MB", "per-line MB/s", "whole MB/s", "speedup");
+  for (const auto &entry : stats) {
+    const Stats &s = entry.second;
+    double line = bench_mb_per_sec(s.bytes, s.lineSeconds);
+    double whole = bench_mb_per_sec(s.bytes, s.wholeSeconds);
+    printf("%-8s %-8s %6d %10.1f %14.1f %14.1f %7.2fx\n",
+           entry.first.first.c_str(), entry.first.second.c_str(), s.files,
+           s.bytes / (1024.0 * 1024.0), line, whole,
+           line > 0 ? whole / line : 0);
+  }
+
+  return 0;
+}
@@ -0,0 +1,301 @@
+// Sparse tile access benchmark for tiled OpenEXR files.
+//
+// openexr_fuzz_tiles reads every tile of every level. A texture system instead
+// reads a few tiles at a time across MIP levels, so this driver replays a tile
+// access trace through TiledInputPart::readTile() with an LRU cache of decoded
+// tiles in front of it, and reports the hit rate, tiles/sec and the latency
+// per level.
+//
+// The trace is either read from a file, one "lx ly dx dy" request per line, or
+// generated: a deterministic random walk that mostly requests neighbours of
+// the previous tile of the same level and sometimes jumps.
+//
+// Usage: openexr_tiles_benchmark [-c cache_tiles] [-n requests] [-p part]
+//            [-T trace] file.exr
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <exception>
+#include <list>
+#include <map>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <ImfFrameBuffer.h>
+#include <ImfHeader.h>
+#include <ImfMultiPartInputFile.h>
+#include <ImfRgba.h>
+#include <ImfThreading.h>
+#include <ImfTileDescription.h>
+#include <ImfTiledInputPart.h>
+
+#include "bench_utils.h"
+
+using namespace OPENEXR_IMF_INTERNAL_NAMESPACE;
+using IMATH_NAMESPACE::Box2i;
+
+namespace {
+
+struct TileRequest {
+  int lx;
+  int ly;
+  int dx;
+  int dy;
+};
+
+uint64_t tileKey(const TileRequest &r) {
+  return ((uint64_t)(r.lx & 0xff) << 56) | ((uint64_t)(r.ly & 0xff) << 48) |
+         ((uint64_t)(r.dx & 0xffffff) << 24) | (uint64_t)(r.dy & 0xffffff);
+}
+
+// Decoded tiles, evicting the least recently used one when full.
+class TileCache {
+ public:
+  explicit TileCache(size_t capacity) : capacity_(capacity) {}
+
+  // Return the cached tile for key, or NULL on a miss.
+  std::vector<Rgba> *lookup(uint64_t key) {
+    auto it = index_.find(key);
+    if (it == index_.end()) return NULL;
+    entries_.splice(entries_.begin(), entries_, it->second);
+    return &it->second->second;
+  }
+
+  // Return storage for a new tile, reusing the evicted tile's buffer.
+  std::vector<Rgba> *insert(uint64_t key) {
+    if (capacity_ == 0) {
+      scratch_.clear();
+      return &scratch_;
+    }
+    if (entries_.size() >= capacity_) {
+      entries_.splice(entries_.begin(), entries_, --entries_.end());
+      index_.erase(entries_.front().first);
+      entries_.front().first = key;
+    } else {
+      entries_.emplace_front(key, std::vector<Rgba>());
+    }
+    index_[key] = entries_.begin();
+    return &entries_.front().second;
+  }
+
+  // Drop key, such as after its tile failed to decode into insert()'s
+  // storage.
+  void erase(uint64_t key) {
+    auto it = index_.find(key);
+    if (it == index_.end()) return;
+    entries_.erase(it->second);
+    index_.erase(it);
+  }
+
+ private:
+  typedef std::list<std::pair<uint64_t, std::vector<Rgba> > > EntryList;
+
+  size_t capacity_;
+  EntryList entries_;
+  std::unordered_map<uint64_t, EntryList::iterator> index_;
+  std::vector<Rgba> scratch_;
+};
+
+struct LevelStats {
+  int requests = 0;
+  int misses = 0;
+  double seconds = 0;
+  double missSeconds = 0;
+};
+
+// xorshift32, so that generated traces are identical across machines.
+class Random {
+ public:
+  explicit Random(uint32_t seed) : state_(seed) {}
+
+  uint32_t next() {
+    state_ ^= state_ << 13;
+    state_ ^= state_ >> 17;
+    state_ ^= state_ << 5;
+    return state_;
+  }
+
+  int below(int n) { return n > 0 ? (int)(next() % (uint32_t)n) : 0; }
+
+ private:
+  uint32_t state_;
+};
+
+std::vector<TileRequest> syntheticTrace(TiledInputPart *in, int count) {
+  bool ripmap = in->header().tileDescription().mode == RIPMAP_LEVELS;
+
+  Random rng(0x7e57u);
+  std::map<std::pair<int, int>, TileRequest> last;
+  std::vector<TileRequest> trace;
+  for (int i = 0; i < count; i++) {
+    TileRequest r;
+    r.lx = rng.below(in->numXLevels());
+    r.ly = ripmap ? rng.below(in->numYLevels()) : r.lx;
+
+    int nx = in->numXTiles(r.lx);
+    int ny = in->numYTiles(r.ly);
+    auto prev = last.find(std::make_pair(r.lx, r.ly));
+    if (prev != last.end() && rng.below(10) < 8) {
+      // Step to a neighbour (or stay) and clamp to the level.
+      r.dx = prev->second.dx + rng.below(3) - 1;
+      r.dy = prev->second.dy + rng.below(3) - 1;
+      r.dx = r.dx < 0 ? 0 : (r.dx >= nx ? nx - 1 : r.dx);
+      r.dy = r.dy < 0 ? 0 : (r.dy >= ny ? ny - 1 : r.dy);
+    } else {
+      r.dx = rng.below(nx);
+      r.dy = rng.below(ny);
+    }
+
+    last[std::make_pair(r.lx, r.ly)] = r;
+    trace.push_back(r);
+  }
+  return trace;
+}
+
+std::vector<TileRequest> readTrace(const char *path) {
+  std::vector<TileRequest> trace;
+  FILE *f = fopen(path, "r");
+  if (f == NULL) {
+    perror(path);
+    return trace;
+  }
+
+  char line[256];
+  while (fgets(line, sizeof(line), f) != NULL) {
+    TileRequest r;
+    if (line[0] == '#') continue;
+    if (sscanf(line, "%d %d %d %d", &r.lx, &r.ly, &r.dx, &r.dy) == 4) {
+      trace.push_back(r);
+    }
+  }
+
+  fclose(f);
+  return trace;
+}
+
+// Decodes one tile into tile, which is resized to the tile's pixel count.
+void decodeTile(TiledInputPart *in, const TileRequest &r,
+                std::vector<Rgba> *tile) {
+  Box2i box = in->dataWindowForTile(r.dx, r.dy, r.lx, r.ly);
+  int w = box.max.x - box.min.x + 1;
+  int h = box.max.y - box.min.y + 1;
+  tile->resize((size_t)w * h);
+
+  // Offset the base so that the tile's absolute pixel coordinates land at the
+  // start of the buffer.
+  Rgba *base = &(*tile)[0] - box.min.x - (ptrdiff_t)box.min.y * w;
+  FrameBuffer i;
+  i.insert("R", Slice(HALF, (char *)&base->r, sizeof(Rgba), w * sizeof(Rgba)));
+  i.insert("G", Slice(HALF, (char *)&base->g, sizeof(Rgba), w * sizeof(Rgba)));
+  i.insert("B", Slice(HALF, (char *)&base->b, sizeof(Rgba), w * sizeof(Rgba)));
+  i.insert("A", Slice(HALF, (char *)&base->a, sizeof(Rgba), w * sizeof(Rgba)));
+
+  in->setFrameBuffer(i);
+  in->readTile(r.dx, r.dy, r.lx, r.ly);
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  size_t capacity = 256;
+  int count = 100000;
+  int part = 0;
+  const char *tracePath = NULL;
+  int opt;
+  while ((opt = getopt(argc, argv, "c:n:p:T:")) != -1) {
+    switch (opt) {
+      case 'c':
+        capacity = strtoul(optarg, NULL, 10);
+        break;
+      case 'n':
+        count = atoi(optarg);
+        break;
+      case 'p':
+        part = atoi(optarg);
+        break;
+      case 'T':
+        tracePath = optarg;
+        break;
+      default:
+        optind = argc;
+        break;
+    }
+  }
+  if (optind != argc - 1) {
+    fprintf(stderr,
+            "usage: %s [-c cache_tiles] [-n requests] [-p part] [-T trace] "
+            "file.exr\n",
+            argv[0]);
+    return 1;
+  }
+  setGlobalThreadCount(0);
+
+  try {
+    MultiPartInputFile file(argv[optind]);
+    TiledInputPart in(file, part);
+
+    std::vector<TileRequest> trace =
+        tracePath ? readTrace(tracePath) : syntheticTrace(&in, count);
+
+    TileCache cache(capacity);
+    std::map<std::pair<int, int>, LevelStats> levels;
+    int served = 0;
+    double start = bench_now();
+    for (const TileRequest &r : trace) {
+      if (!in.isValidTile(r.dx, r.dy, r.lx, r.ly)) continue;
+
+      double t0 = bench_now();
+      uint64_t key = tileKey(r);
+      bool hit = cache.lookup(key) != NULL;
+      if (!hit) {
+        try {
+          decodeTile(&in, r, cache.insert(key));
+        } catch (const std::exception &e) {
+          cache.erase(key);
+          fprintf(stderr, "tile (%d, %d, %d, %d): %s\n", r.lx, r.ly, r.dx,
+                  r.dy, e.what());
+        }
+      }
+      double elapsed = bench_now() - t0;
+
+      LevelStats &s = levels[std::make_pair(r.lx, r.ly)];
+      s.requests++;
+      s.seconds += elapsed;
+      if (!hit) {
+        s.misses++;
+        s.missSeconds += elapsed;
+      }
+      served++;
+    }
+    double seconds = bench_now() - start;
+
+    printf("%-8s %10s %10s %9s %12s %14s\n", "level", "requests", "misses",
+           "hit rate", "avg us", "avg miss us");
+    int misses = 0;
+    for (const auto &entry : levels) {
+      const LevelStats &s = entry.second;
+      misses += s.misses;
+      printf("%3d,%-4d %10d %10d %8.1f%% %12.1f %14.1f\n", entry.first.first,
+             entry.first.second, s.requests, s.misses,
+             100.0 * (s.requests - s.misses) / s.requests,
+             1e6 * s.seconds / s.requests,
+             s.misses ? 1e6 * s.missSeconds / s.misses : 0.0);
+    }
+
+    printf("cache: %zu tiles, requests: %d, hit rate: %.1f%%, "
+           "tiles/sec: %.0f\n",
+           capacity, served,
+           served ? 100.0 * (served - misses) / served : 0.0,
+           seconds > 0 ? served / seconds : 0.0);
+  } catch (const std::exception &e) {
+    fprintf(stderr, "%s: %s\n", argv[optind], e.what());
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,31 @@
+#include "uriparser_bench_corpus.h"
+
+#include "bench_utils.h"
+
+std::vector<UriPair> ReadUriPairs(const char *path) {
+  std::vector<UriPair> pairs;
+  std::string data;
+  if (bench_read_file(path, &data) != 0) return pairs;
+
+  size_t pos = 0;
+  while (pos < data.size()) {
+    size_t end = data.find('\n', pos);
+    if (end == std::string::npos) end = data.size();
+    std::string line = data.substr(pos, end - pos);
+    pos = end + 1;
+
+    size_t split = line.find_first_of(" \t");
+    if (split == std::string::npos) continue;
+    size_t relative = line.find_first_not_of(" \t", split);
+    if (relative == std::string::npos) continue;
+    size_t relativeEnd = line.find_first_of(" \t\r", relative);
+
+    UriPair pair;
+    pair.base = line.substr(0, split);
+    pair.relative = line.substr(relative, relativeEnd == std::string::npos
+                                              ? std::string::npos
+                                              : relativeEnd - relative);
+    pairs.push_back(pair);
+  }
+  return pairs;
+}
@@ -0,0 +1,20 @@
+// Corpus format shared by the uriparser benchmarks: one (base, relative)
+// pair per line, "<base> <relative>", separated by spaces or tabs.
+
+#ifndef URIPARSER_BENCH_CORPUS_H_
+#define URIPARSER_BENCH_CORPUS_H_
+
+#include <string>
+#include <vector>
+
+struct UriPair {
+  std::string base;
+  std::string relative;
+};
+
+// Read the pairs in the file at path. Lines without a relative reference
+// are skipped, as is anything after it. Returns no pairs if the file cannot
+// be read.
+std::vector<UriPair> ReadUriPairs(const char *path);
+
+#endif  // URIPARSER_BENCH_CORPUS_H_
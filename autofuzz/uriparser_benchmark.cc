@@ -0,0 +1,188 @@
+// Reference resolution benchmark for uriparser.
+//
+// Feeds (base, relative) pairs through the sequence of uriparser_fuzzer's
+// proto harness, with the relative reference as uri1 and the base as uri2:
+// parse both, compare them, normalize uri1, resolve it against the base and
+// remove the base again. Base removal is applied to the resolved URI, since
+// uriparser rejects relative sources there.
+//
+// Each stage runs over the whole corpus in its own pass so that it can be
+// timed without per-call clock reads. Rates are per pair (two URIs for the
+// parse stage). The UriUriA structs are reused across repeats, and a counting
+// UriMemoryManager reports allocations per pair.
+//
+// The corpus has one pair per line: "<base> <relative>".
+//
+// Usage: uriparser_benchmark [-r repeats] corpus.txt
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+#include "bench_utils.h"
+#include "uriparser/include/uriparser/Uri.h"
+#include "uriparser_bench_corpus.h"
+
+namespace {
+
+// Parsed state for one pair, reused across repeats.
+struct ParsedPair {
+  UriUriA relative;
+  UriUriA base;
+  UriUriA resolved;
+  UriUriA rebased;
+  bool parsed;
+  bool resolvedOk;
+  bool rebasedOk;
+};
+
+struct Stage {
+  const char *name;
+  double seconds;
+  size_t allocations;
+};
+
+size_t allocations = 0;
+
+void *countingMalloc(UriMemoryManager *, size_t size) {
+  allocations++;
+  return malloc(size);
+}
+
+void *countingCalloc(UriMemoryManager *, size_t nmemb, size_t size) {
+  allocations++;
+  return calloc(nmemb, size);
+}
+
+void *countingRealloc(UriMemoryManager *, void *ptr, size_t size) {
+  allocations++;
+  return realloc(ptr, size);
+}
+
+void *countingReallocarray(UriMemoryManager *, void *ptr, size_t nmemb,
+                           size_t size) {
+  allocations++;
+  if (size != 0 && nmemb > (size_t)-1 / size) return NULL;
+  return realloc(ptr, nmemb * size);
+}
+
+void countingFree(UriMemoryManager *, void *ptr) { free(ptr); }
+
+UriMemoryManager countingMemoryManager = {
+    countingMalloc,       countingCalloc, countingRealloc,
+    countingReallocarray, countingFree,   NULL};
+
+bool parse(const std::string &s, UriUriA *uri) {
+  return uriParseSingleUriExMmA(uri, s.data(), s.data() + s.size(), NULL,
+                                &countingMemoryManager) == URI_SUCCESS;
+}
+
+template <typename Fn>
+void runStage(Stage *stage, std::vector<ParsedPair> *parsed, Fn fn) {
+  size_t before = allocations;
+  double start = bench_now();
+  for (size_t i = 0; i < parsed->size(); i++) fn(&(*parsed)[i], i);
+  stage->seconds += bench_now() - start;
+  stage->allocations += allocations - before;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  int repeats = 5;
+  int opt;
+  while ((opt = getopt(argc, argv, "r:")) != -1) {
+    switch (opt) {
+      case 'r':
+        repeats = atoi(optarg);
+        break;
+      default:
+        optind = argc;
+        break;
+    }
+  }
+  if (optind != argc - 1) {
+    fprintf(stderr, "usage: %s [-r repeats] corpus.txt\n", argv[0]);
+    return 1;
+  }
+  if (repeats < 1) repeats = 1;
+
+  const std::vector<UriPair> pairs = ReadUriPairs(argv[optind]);
+  std::vector<ParsedPair> parsed(pairs.size());
+  memset(parsed.data(), 0, parsed.size() * sizeof(ParsedPair));
+
+  Stage parseStage = {"parse", 0, 0};
+  Stage equalsStage = {"equals", 0, 0};
+  Stage normalizeStage = {"normalize", 0, 0};
+  Stage resolveStage = {"add base", 0, 0};
+  Stage rebaseStage = {"remove base", 0, 0};
+  Stage freeStage = {"free", 0, 0};
+  size_t equal = 0;
+
+  for (int r = 0; r < repeats; r++) {
+    runStage(&parseStage, &parsed, [&](ParsedPair *p, size_t i) {
+      p->parsed = parse(pairs[i].relative, &p->relative);
+      if (p->parsed && !parse(pairs[i].base, &p->base)) {
+        uriFreeUriMembersMmA(&p->relative, &countingMemoryManager);
+        p->parsed = false;
+      }
+    });
+
+    runStage(&equalsStage, &parsed, [&](ParsedPair *p, size_t) {
+      if (p->parsed && uriEqualsUriA(&p->relative, &p->base)) equal++;
+    });
+
+    runStage(&normalizeStage, &parsed, [&](ParsedPair *p, size_t) {
+      if (!p->parsed) return;
+      uriNormalizeSyntaxExMmA(&p->relative,
+                              uriNormalizeSyntaxMaskRequiredA(&p->relative),
+                              &countingMemoryManager);
+    });
+
+    runStage(&resolveStage, &parsed, [&](ParsedPair *p, size_t) {
+      p->resolvedOk =
+          p->parsed &&
+          uriAddBaseUriExMmA(&p->resolved, &p->relative, &p->base,
+                             URI_RESOLVE_STRICTLY,
+                             &countingMemoryManager) == URI_SUCCESS;
+    });
+
+    runStage(&rebaseStage, &parsed, [&](ParsedPair *p, size_t) {
+      p->rebasedOk =
+          p->resolvedOk &&
+          uriRemoveBaseUriMmA(&p->rebased, &p->resolved, &p->base, URI_FALSE,
+                              &countingMemoryManager) == URI_SUCCESS;
+    });
+
+    runStage(&freeStage, &parsed, [&](ParsedPair *p, size_t) {
+      if (p->rebasedOk) {
+        uriFreeUriMembersMmA(&p->rebased, &countingMemoryManager);
+      }
+      if (p->resolvedOk) {
+        uriFreeUriMembersMmA(&p->resolved, &countingMemoryManager);
+      }
+      if (p->parsed) {
+        uriFreeUriMembersMmA(&p->relative, &countingMemoryManager);
+        uriFreeUriMembersMmA(&p->base, &countingMemoryManager);
+      }
+    });
+  }
+
+  const double total = (double)pairs.size() * repeats;
+  printf("pairs: %zu, repeats: %d, equal: %zu\n", pairs.size(), repeats,
+         equal / repeats);
+  printf("%-12s %14s %14s\n", "stage", "pairs/sec", "allocs/pair");
+  const Stage *stages[] = {&parseStage,   &equalsStage, &normalizeStage,
+                           &resolveStage, &rebaseStage, &freeStage};
+  for (const Stage *stage : stages) {
+    printf("%-12s %14.0f %14.2f\n", stage->name,
+           stage->seconds > 0 ? total / stage->seconds : 0,
+           total > 0 ? stage->allocations / total : 0);
+  }
+
+  return 0;
+}
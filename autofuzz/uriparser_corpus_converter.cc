@@ -0,0 +1,95 @@
+// Converts corpus files between uriparser_fuzzer (UriParserData in protobuf
+// text format, as written by libprotobuf-mutator) and uriparser_raw_fuzzer.
+//
+// Usage: uriparser_corpus_converter to-raw|to-proto <in_dir> <out_dir>
+
+#include <dirent.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <string>
+
+#include "bench_utils.h"
+#include "google/protobuf/text_format.h"
+#include "uriparser_fuzz_common.h"
+#include "uriparser_fuzzer.pb.h"
+
+using third_party::uriparser::fuzzers::UriParserData;
+
+namespace {
+
+bool ToRaw(const std::string &in, std::string *out) {
+  UriParserData proto;
+  if (!google::protobuf::TextFormat::ParseFromString(in, &proto)) {
+    return false;
+  }
+
+  UriParserInput input;
+  input.uri1 = proto.uri1();
+  input.uri2 = proto.uri2();
+  input.domain_relative = proto.domainrelative();
+  *out = EncodeRawInput(input);
+  return true;
+}
+
+bool ToProto(const std::string &in, std::string *out) {
+  UriParserInput input =
+      DecodeRawInput(reinterpret_cast<const uint8_t *>(in.data()), in.size());
+
+  UriParserData proto;
+  proto.set_uri1(input.uri1);
+  proto.set_uri2(input.uri2);
+  proto.set_domainrelative(input.domain_relative);
+  return google::protobuf::TextFormat::PrintToString(proto, out);
+}
+
+bool WriteFile(const std::string &path, const std::string &data) {
+  FILE *f = fopen(path.c_str(), "wb");
+  if (f == nullptr) {
+    perror(path.c_str());
+    return false;
+  }
+  bool ok = fwrite(data.data(), 1, data.size(), f) == data.size();
+  ok &= fclose(f) == 0;
+  return ok;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  if (argc != 4 ||
+      (strcmp(argv[1], "to-raw") != 0 && strcmp(argv[1], "to-proto") != 0)) {
+    fprintf(stderr, "usage: %s to-raw|to-proto <in_dir> <out_dir>\n", argv[0]);
+    return 1;
+  }
+  bool to_raw = strcmp(argv[1], "to-raw") == 0;
+  const std::string in_dir = argv[2];
+  const std::string out_dir = argv[3];
+
+  DIR *dir = opendir(in_dir.c_str());
+  if (dir == nullptr) {
+    perror(in_dir.c_str());
+    return 1;
+  }
+
+  int converted = 0;
+  int failed = 0;
+  while (struct dirent *entry = readdir(dir)) {
+    if (entry->d_name[0] == '.') continue;
+
+    std::string in;
+    std::string out;
+    if (bench_read_file((in_dir + "/" + entry->d_name).c_str(), &in) != 0 ||
+        !(to_raw ? ToRaw(in, &out) : ToProto(in, &out)) ||
+        !WriteFile(out_dir + "/" + entry->d_name, out)) {
+      fprintf(stderr, "%s: not converted\n", entry->d_name);
+      failed++;
+      continue;
+    }
+    converted++;
+  }
+  closedir(dir);
+
+  printf("converted: %d, failed: %d\n", converted, failed);
+  return failed == 0 ? 0 : 1;
+}
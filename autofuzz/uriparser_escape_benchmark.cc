@@ -0,0 +1,215 @@
+// Percent-encoding benchmark for uriparser.
+//
+// Runs the escape paths of uriparser_fuzzer's Escapes() and FileNames() over
+// long query strings and reports MB/s of input for each:
+//   - escape: uriEscapeA with and without space-to-plus and line break
+//     normalization;
+//   - unescape: uriUnescapeInPlaceA over the plainly escaped strings, and
+//     uriUnescapeInPlaceExA over the space-to-plus, normalized ones;
+//   - filename: Unix and Windows filename to URI string and back.
+// Output buffers are sized once for the longest input and reused.
+//
+// Inputs are read one per line from the given files. Without files, queries
+// of a few sizes are generated from a fixed seed, with a mix of unreserved,
+// reserved and non-ASCII bytes similar to what a log normaliser sees.
+//
+// Usage: uriparser_escape_benchmark [-r repeats] [-n queries] [file...]
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+#include "bench_utils.h"
+#include "uriparser/include/uriparser/Uri.h"
+
+namespace {
+
+struct Stage {
+  const char *name;
+  double seconds;
+  double bytes;
+};
+
+// xorshift32, so that generated queries are identical across machines.
+uint32_t nextRandom(uint32_t *state) {
+  *state ^= *state << 13;
+  *state ^= *state >> 17;
+  *state ^= *state << 5;
+  return *state;
+}
+
+std::string syntheticQuery(uint32_t *state, size_t length) {
+  static const char kUnreserved[] =
+      "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789-._~";
+  static const char kReserved[] = " &=+/?#%:@!$'()*,;[]\"<>\\^`{|}";
+
+  std::string query;
+  query.reserve(length);
+  while (query.size() < length) {
+    uint32_t r = nextRandom(state);
+    switch (r % 16) {
+      case 0:
+      case 1:
+        query += kReserved[(r >> 4) % (sizeof(kReserved) - 1)];
+        break;
+      case 2:
+        query += (char)(0x80 | ((r >> 4) & 0x7f));
+        break;
+      case 3:
+        query += (r & 0x10) ? '&' : '=';
+        break;
+      default:
+        query += kUnreserved[(r >> 4) % (sizeof(kUnreserved) - 1)];
+        break;
+    }
+  }
+  return query;
+}
+
+std::vector<std::string> readLines(const char *path) {
+  std::vector<std::string> lines;
+  std::string data;
+  if (bench_read_file(path, &data) != 0) return lines;
+
+  size_t pos = 0;
+  while (pos < data.size()) {
+    size_t end = data.find('\n', pos);
+    if (end == std::string::npos) end = data.size();
+    if (end > pos) lines.push_back(data.substr(pos, end - pos));
+    pos = end + 1;
+  }
+  return lines;
+}
+
+// Copy every string in from into the matching buffer of *to, which is only
+// ever grown.
+void copyAll(const std::vector<std::vector<char> > &from,
+             std::vector<std::vector<char> > *to) {
+  for (size_t i = 0; i < from.size(); i++) {
+    size_t length = strlen(from[i].data()) + 1;
+    if ((*to)[i].size() < length) (*to)[i].resize(length);
+    memcpy((*to)[i].data(), from[i].data(), length);
+  }
+}
+
+template <typename Fn>
+void runStage(Stage *stage, const std::vector<std::string> &inputs, Fn fn) {
+  double start = bench_now();
+  for (size_t i = 0; i < inputs.size(); i++) fn(inputs[i], i);
+  stage->seconds += bench_now() - start;
+  for (const std::string &input : inputs) stage->bytes += input.size();
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  int repeats = 5;
+  int count = 1000;
+  int opt;
+  while ((opt = getopt(argc, argv, "r:n:")) != -1) {
+    switch (opt) {
+      case 'r':
+        repeats = atoi(optarg);
+        break;
+      case 'n':
+        count = atoi(optarg);
+        break;
+      default:
+        fprintf(stderr, "usage: %s [-r repeats] [-n queries] [file...]\n",
+                argv[0]);
+        return 1;
+    }
+  }
+  if (repeats < 1) repeats = 1;
+
+  std::vector<std::string> inputs;
+  for (int i = optind; i < argc; i++) {
+    std::vector<std::string> lines = readLines(argv[i]);
+    inputs.insert(inputs.end(), lines.begin(), lines.end());
+  }
+  if (optind == argc) {
+    static const size_t kLengths[] = {256, 4096, 65536};
+    uint32_t state = 0x5eedu;
+    for (int i = 0; i < count; i++) {
+      inputs.push_back(syntheticQuery(&state, kLengths[i % 3]));
+    }
+  }
+
+  size_t longest = 0;
+  for (const std::string &input : inputs) {
+    if (input.size() > longest) longest = input.size();
+  }
+
+  // Escaped copies of every input, kept so that unescaping can be timed on
+  // its own. Unescaping works in place, so each stage first copies them into
+  // work outside of the timed loop.
+  std::vector<std::vector<char> > escaped(inputs.size());
+  std::vector<std::vector<char> > escapedPlus(inputs.size());
+  std::vector<std::vector<char> > work(inputs.size());
+  std::vector<char> fileUri(8 + 3 * longest + 1);
+  std::vector<char> fileName(8 + 3 * longest + 1);
+
+  Stage escapeStage = {"escape", 0, 0};
+  Stage escapePlusStage = {"escape +/br", 0, 0};
+  Stage unescapeStage = {"unescape", 0, 0};
+  Stage unescapeExStage = {"unescape ex", 0, 0};
+  Stage unixStage = {"unix file", 0, 0};
+  Stage windowsStage = {"windows file", 0, 0};
+
+  for (int r = 0; r < repeats; r++) {
+    runStage(&escapePlusStage, inputs, [&](const std::string &in, size_t i) {
+      std::vector<char> &out = escapedPlus[i];
+      if (out.size() < in.size() * 6 + 1) out.resize(in.size() * 6 + 1);
+      uriEscapeA(in.c_str(), out.data(), URI_TRUE, URI_TRUE);
+    });
+
+    runStage(&escapeStage, inputs, [&](const std::string &in, size_t i) {
+      std::vector<char> &out = escaped[i];
+      if (out.size() < in.size() * 6 + 1) out.resize(in.size() * 6 + 1);
+      uriEscapeA(in.c_str(), out.data(), URI_FALSE, URI_FALSE);
+    });
+
+    copyAll(escaped, &work);
+    runStage(&unescapeStage, inputs, [&](const std::string &, size_t i) {
+      uriUnescapeInPlaceA(work[i].data());
+    });
+
+    copyAll(escapedPlus, &work);
+    runStage(&unescapeExStage, inputs, [&](const std::string &, size_t i) {
+      uriUnescapeInPlaceExA(work[i].data(), URI_TRUE, URI_BR_TO_LF);
+    });
+
+    runStage(&unixStage, inputs, [&](const std::string &in, size_t) {
+      if (uriUnixFilenameToUriStringA(in.c_str(), fileUri.data()) ==
+          URI_SUCCESS) {
+        uriUriStringToUnixFilenameA(fileUri.data(), fileName.data());
+      }
+    });
+
+    runStage(&windowsStage, inputs, [&](const std::string &in, size_t) {
+      if (uriWindowsFilenameToUriStringA(in.c_str(), fileUri.data()) ==
+          URI_SUCCESS) {
+        uriUriStringToWindowsFilenameA(fileUri.data(), fileName.data());
+      }
+    });
+  }
+
+  double bytes = 0;
+  for (const std::string &input : inputs) bytes += input.size();
+  printf("inputs: %zu, bytes: %.0f, longest: %zu, repeats: %d\n",
+         inputs.size(), bytes, longest, repeats);
+  printf("%-14s %12s\n", "stage", "MB/s");
+  const Stage *stages[] = {&escapeStage,     &escapePlusStage, &unescapeStage,
+                           &unescapeExStage, &unixStage,       &windowsStage};
+  for (const Stage *stage : stages) {
+    printf("%-14s %12.1f\n", stage->name,
+           bench_mb_per_sec(stage->bytes, stage->seconds));
+  }
+
+  return 0;
+}
@@ -0,0 +1,241 @@
+#include "uriparser_fuzz_common.h"
+
+#include <fuzzer/FuzzedDataProvider.h>
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "uriparser/include/uriparser/Uri.h"
+#include "uriparser/include/uriparser/UriBase.h"
+
+class UriParserA {
+ public:
+  UriParserA() { memset((void *)&uri_, 0, sizeof(uri_)); }
+  ~UriParserA() { uriFreeUriMembersA(&uri_); }
+
+  UriUriA *get_mutable_uri() { return &uri_; }
+  UriUriA *get_uri() const { return const_cast<UriUriA *>(&uri_); }
+
+ private:
+  UriUriA uri_;
+};
+
+class UriParserW {
+ public:
+  UriParserW() { memset((void *)&uri_, 0, sizeof(uri_)); }
+  ~UriParserW() { uriFreeUriMembersW(&uri_); }
+
+  UriUriW *get_mutable_uri() { return &uri_; }
+
+ private:
+  UriUriW uri_;
+};
+
+// Grow buf to at least size chars. Buffers are only ever grown, so after a
+// few runs they are neither reallocated nor cleared.
+static char *Reserve(std::vector<char> *buf, size_t size) {
+  if (buf->size() < size) buf->resize(size);
+  return buf->data();
+}
+
+void Escapes(const std::string &uri) {
+  static std::vector<char> buf;
+  const char *first = uri.c_str();
+  // A new line char takes 6 char to encode.
+  char *out = Reserve(&buf, uri.size() * 6 + 1);
+
+  uriEscapeA(first, out, URI_TRUE, URI_TRUE);
+  uriUnescapeInPlaceExA(out, URI_TRUE, URI_BR_TO_LF);
+
+  uriEscapeA(first, out, URI_FALSE, URI_FALSE);
+  uriUnescapeInPlaceA(out);
+}
+
+void FileNames(const std::string &uri) {
+  static std::vector<char> buf;
+  static std::vector<char> back;
+  // "file:///" plus 3 chars per escaped char; converting back only shrinks.
+  char *out = Reserve(&buf, 8 + 3 * uri.size() + 1);
+  char *filename = Reserve(&back, 8 + 3 * uri.size() + 1);
+
+  if (uriUnixFilenameToUriStringA(uri.c_str(), out) == URI_SUCCESS) {
+    uriUriStringToUnixFilenameA(out, filename);
+  }
+  if (uriWindowsFilenameToUriStringA(uri.c_str(), out) == URI_SUCCESS) {
+    uriUriStringToWindowsFilenameA(out, filename);
+  }
+
+  uriUriStringToUnixFilenameA(uri.c_str(), out);
+  uriUriStringToWindowsFilenameA(uri.c_str(), out);
+}
+
+// Yuck!  The header situation for uriparse is rough.
+extern "C" {
+int uriParseIpFourAddressA(unsigned char *octetOutput, const char *first,
+                           const char *afterLast);
+}
+
+void Ipv4(const std::string &s) {
+  const char *cstr = s.c_str();
+  unsigned char result[4] = {};
+  uriParseIpFourAddressA(result, cstr, &cstr[s.size()]);
+}
+
+void FuzzUriParser(const UriParserInput &input) {
+  const std::string &uri1 = input.uri1;
+  const std::string &uri2 = input.uri2;
+
+  Escapes(uri1);
+  Escapes(uri2);
+
+  FileNames(uri1);
+  FileNames(uri2);
+
+  Ipv4(uri1);
+  Ipv4(uri2);
+
+  UriParserA parser1;
+  UriParserStateA state1;
+  state1.uri = parser1.get_mutable_uri();
+  if (URI_SUCCESS != uriParseUriA(&state1, uri1.c_str())) return;
+
+  // Compute how large a resulting std::string would be for a URI, and
+  // serialize into a buffer of exactly that size. The buffer only ever grows,
+  // so it is neither reallocated nor cleared on most runs.
+  {
+    static std::vector<char> buf;
+    int length = 0;
+    if (uriToStringCharsRequiredA(state1.uri, &length) == URI_SUCCESS) {
+      const size_t size = static_cast<size_t>(length) + 1;
+      char *out = Reserve(&buf, size);
+      int written = 0;
+      uriToStringA(out, state1.uri, static_cast<int>(size), &written);
+    }
+  }
+
+  UriParserA parser2;
+  UriParserStateA state2;
+  state2.uri = parser2.get_mutable_uri();
+  if (URI_SUCCESS != uriParseUriA(&state2, uri2.c_str())) return;
+
+  uriEqualsUriA(state1.uri, state2.uri);
+
+  uriNormalizeSyntaxA(state1.uri);
+
+  UriUriA absUri;
+  uriAddBaseUriA(&absUri, state1.uri, state2.uri);
+  uriFreeUriMembersA(&absUri);
+
+  UriUriA relUri;
+  uriRemoveBaseUriA(&relUri, state1.uri, state2.uri,
+                    input.domain_relative ? URI_TRUE : URI_FALSE);
+  uriFreeUriMembersA(&relUri);
+}
+
+void WidenUtf8(const std::string &in, std::wstring *out) {
+  out->clear();
+  out->reserve(in.size());
+  const unsigned char *p = (const unsigned char *)in.data();
+  const unsigned char *end = p + in.size();
+  while (p < end) {
+    const unsigned char c = *p;
+    size_t length = 0;
+    uint32_t code = c;
+    uint32_t min = 0;
+    if (c >= 0xc0 && c < 0xe0) {
+      length = 2;
+      code = c & 0x1f;
+      min = 0x80;
+    } else if (c >= 0xe0 && c < 0xf0) {
+      length = 3;
+      code = c & 0x0f;
+      min = 0x800;
+    } else if (c >= 0xf0 && c < 0xf8) {
+      length = 4;
+      code = c & 0x07;
+      min = 0x10000;
+    }
+
+    bool valid = length > 0 && static_cast<size_t>(end - p) >= length;
+    for (size_t i = 1; valid && i < length; i++) {
+      valid = (p[i] & 0xc0) == 0x80;
+      code = (code << 6) | (p[i] & 0x3f);
+    }
+    // Reject overlong forms, surrogates and code points wchar_t cannot hold.
+    valid = valid && code >= min && code <= 0x10ffff &&
+            (code < 0xd800 || code >= 0xe000) &&
+            (code <= 0xffff || sizeof(wchar_t) >= 4);
+
+    if (valid) {
+      out->push_back(static_cast<wchar_t>(code));
+      p += length;
+    } else {
+      out->push_back(static_cast<wchar_t>(c));
+      p++;
+    }
+  }
+}
+
+void FuzzUriParserW(const UriParserInput &input) {
+  static std::wstring uri1;
+  static std::wstring uri2;
+  WidenUtf8(input.uri1, &uri1);
+  WidenUtf8(input.uri2, &uri2);
+
+  UriParserW parser1;
+  UriParserStateW state1;
+  state1.uri = parser1.get_mutable_uri();
+  if (URI_SUCCESS != uriParseUriW(&state1, uri1.c_str())) return;
+
+  {
+    static std::vector<wchar_t> buf;
+    int length = 0;
+    if (uriToStringCharsRequiredW(state1.uri, &length) == URI_SUCCESS) {
+      const size_t size = static_cast<size_t>(length) + 1;
+      if (buf.size() < size) buf.resize(size);
+      int written = 0;
+      uriToStringW(buf.data(), state1.uri, static_cast<int>(size), &written);
+    }
+  }
+
+  UriParserW parser2;
+  UriParserStateW state2;
+  state2.uri = parser2.get_mutable_uri();
+  if (URI_SUCCESS != uriParseUriW(&state2, uri2.c_str())) return;
+
+  uriEqualsUriW(state1.uri, state2.uri);
+
+  uriNormalizeSyntaxW(state1.uri);
+
+  UriUriW absUri;
+  uriAddBaseUriW(&absUri, state1.uri, state2.uri);
+  uriFreeUriMembersW(&absUri);
+
+  UriUriW relUri;
+  uriRemoveBaseUriW(&relUri, state1.uri, state2.uri,
+                    input.domain_relative ? URI_TRUE : URI_FALSE);
+  uriFreeUriMembersW(&relUri);
+}
+
+UriParserInput DecodeRawInput(const uint8_t *data, size_t size) {
+  FuzzedDataProvider provider(data, size);
+  UriParserInput input;
+  input.domain_relative = provider.ConsumeBool();
+  input.uri1 = provider.ConsumeRandomLengthString();
+  input.uri2 = provider.ConsumeRemainingBytesAsString();
+  return input;
+}
+
+std::string EncodeRawInput(const UriParserInput &input) {
+  std::string raw;
+  for (char c : input.uri1) {
+    raw += c;
+    if (c == '\\') raw += c;
+  }
+  raw += "\\ ";
+  raw += input.uri2;
+  raw += input.domain_relative ? '\x01' : '\x00';
+  return raw;
+}
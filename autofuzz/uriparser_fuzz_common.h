@@ -0,0 +1,41 @@
+// Shared body of the uriparser fuzz targets, and the raw input layout used by
+// uriparser_raw_fuzzer.
+
+#ifndef URIPARSER_FUZZ_COMMON_H_
+#define URIPARSER_FUZZ_COMMON_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+
+// The fields of the UriParserData proto.
+struct UriParserInput {
+  std::string uri1;
+  std::string uri2;
+  bool domain_relative;
+};
+
+// Run the escaping, file name, IPv4, parse, serialize, compare, normalize and
+// base add/remove checks on one input.
+void FuzzUriParser(const UriParserInput &input);
+
+// The parse, serialize, compare, normalize and base add/remove checks of
+// FuzzUriParser() through the wchar_t (...W) API. Both URIs are converted
+// once with WidenUtf8() before any uriparser call.
+void FuzzUriParserW(const UriParserInput &input);
+
+// Decode UTF-8 into out, replacing *out. Bytes that are not part of a valid
+// sequence are widened as Latin-1, so every input has a wide form.
+void WidenUtf8(const std::string &in, std::wstring *out);
+
+// Raw layout, read with FuzzedDataProvider:
+//   uri1 as ConsumeRandomLengthString() ('\' doubled, ended by "\ "),
+//   uri2 as the remaining bytes,
+//   domain_relative from the low bit of the last byte.
+UriParserInput DecodeRawInput(const uint8_t *data, size_t size);
+
+// Inverse of DecodeRawInput(), used to convert proto corpora.
+std::string EncodeRawInput(const UriParserInput &input);
+
+#endif  // URIPARSER_FUZZ_COMMON_H_
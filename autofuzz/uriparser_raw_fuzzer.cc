@@ -0,0 +1,14 @@
+// uriparser_fuzzer without libprotobuf-mutator: the same three fields are read
+// from a compact raw layout (see DecodeRawInput()), so no proto is parsed or
+// serialized per execution. uriparser_corpus_converter translates corpora
+// between the two targets.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "uriparser_fuzz_common.h"
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+  FuzzUriParser(DecodeRawInput(data, size));
+  return 0;
+}
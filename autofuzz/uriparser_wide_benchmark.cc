@@ -0,0 +1,215 @@
+// char vs wchar_t API benchmark for uriparser.
+//
+// Runs the sequence of uriparser_wide_fuzzer over the same URIs through the
+// ...A and the ...W functions: parse the relative reference and the base,
+// normalize the relative reference and resolve it against the base. The W
+// pass starts from strings that were widened ahead of time, as they would be
+// for UTF-16 input, and the cost of widening UTF-8 is reported separately so
+// that transcoding early can be compared with staying in UTF-8.
+//
+// As in uriparser_benchmark, each stage runs over the whole corpus in its own
+// pass, so parse, normalize, resolve and free are timed separately for A and
+// W. Rates are per pair. The corpus has one pair per line,
+// "<base> <relative>".
+//
+// Usage: uriparser_wide_benchmark [-r repeats] corpus.txt
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+#include "bench_utils.h"
+#include "uriparser/include/uriparser/Uri.h"
+#include "uriparser_bench_corpus.h"
+#include "uriparser_fuzz_common.h"
+
+namespace {
+
+struct WidePair {
+  std::wstring base;
+  std::wstring relative;
+};
+
+// Parsed state for one pair, reused across repeats. UriUriT is UriUriA or
+// UriUriW.
+template <typename UriUriT>
+struct ParsedPair {
+  UriUriT relative;
+  UriUriT base;
+  UriUriT resolved;
+  bool parsed;
+  bool resolvedOk;
+};
+
+struct Stages {
+  double parse = 0;
+  double normalize = 0;
+  double resolve = 0;
+  double free = 0;
+};
+
+template <typename T, typename Fn>
+void runStage(double *seconds, std::vector<T> *parsed, Fn fn) {
+  double start = bench_now();
+  for (size_t i = 0; i < parsed->size(); i++) fn(&(*parsed)[i], i);
+  *seconds += bench_now() - start;
+}
+
+bool parseA(const std::string &s, UriUriA *uri) {
+  const char *errorPos;
+  return uriParseSingleUriExA(uri, s.data(), s.data() + s.size(),
+                              &errorPos) == URI_SUCCESS;
+}
+
+bool parseW(const std::wstring &s, UriUriW *uri) {
+  const wchar_t *errorPos;
+  return uriParseSingleUriExW(uri, s.data(), s.data() + s.size(),
+                              &errorPos) == URI_SUCCESS;
+}
+
+// One repeat of the A stages. Returns the number of pairs that resolved.
+size_t runNarrow(const std::vector<UriPair> &pairs,
+                 std::vector<ParsedPair<UriUriA> > *parsed, Stages *stages) {
+  runStage(&stages->parse, parsed, [&](ParsedPair<UriUriA> *p, size_t i) {
+    p->parsed = parseA(pairs[i].relative, &p->relative);
+    if (p->parsed && !parseA(pairs[i].base, &p->base)) {
+      uriFreeUriMembersA(&p->relative);
+      p->parsed = false;
+    }
+  });
+
+  runStage(&stages->normalize, parsed, [](ParsedPair<UriUriA> *p, size_t) {
+    if (p->parsed) uriNormalizeSyntaxA(&p->relative);
+  });
+
+  size_t resolved = 0;
+  runStage(&stages->resolve, parsed, [&](ParsedPair<UriUriA> *p, size_t) {
+    p->resolvedOk =
+        p->parsed &&
+        uriAddBaseUriA(&p->resolved, &p->relative, &p->base) == URI_SUCCESS;
+    if (p->resolvedOk) resolved++;
+  });
+
+  runStage(&stages->free, parsed, [](ParsedPair<UriUriA> *p, size_t) {
+    if (p->resolvedOk) uriFreeUriMembersA(&p->resolved);
+    if (p->parsed) {
+      uriFreeUriMembersA(&p->relative);
+      uriFreeUriMembersA(&p->base);
+    }
+  });
+  return resolved;
+}
+
+// One repeat of the W stages over pairs widened ahead of time.
+size_t runWide(const std::vector<WidePair> &pairs,
+               std::vector<ParsedPair<UriUriW> > *parsed, Stages *stages) {
+  runStage(&stages->parse, parsed, [&](ParsedPair<UriUriW> *p, size_t i) {
+    p->parsed = parseW(pairs[i].relative, &p->relative);
+    if (p->parsed && !parseW(pairs[i].base, &p->base)) {
+      uriFreeUriMembersW(&p->relative);
+      p->parsed = false;
+    }
+  });
+
+  runStage(&stages->normalize, parsed, [](ParsedPair<UriUriW> *p, size_t) {
+    if (p->parsed) uriNormalizeSyntaxW(&p->relative);
+  });
+
+  size_t resolved = 0;
+  runStage(&stages->resolve, parsed, [&](ParsedPair<UriUriW> *p, size_t) {
+    p->resolvedOk =
+        p->parsed &&
+        uriAddBaseUriW(&p->resolved, &p->relative, &p->base) == URI_SUCCESS;
+    if (p->resolvedOk) resolved++;
+  });
+
+  runStage(&stages->free, parsed, [](ParsedPair<UriUriW> *p, size_t) {
+    if (p->resolvedOk) uriFreeUriMembersW(&p->resolved);
+    if (p->parsed) {
+      uriFreeUriMembersW(&p->relative);
+      uriFreeUriMembersW(&p->base);
+    }
+  });
+  return resolved;
+}
+
+double rate(double total, double seconds) {
+  return seconds > 0 ? total / seconds : 0;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  int repeats = 5;
+  int opt;
+  while ((opt = getopt(argc, argv, "r:")) != -1) {
+    switch (opt) {
+      case 'r':
+        repeats = atoi(optarg);
+        break;
+      default:
+        optind = argc;
+        break;
+    }
+  }
+  if (optind != argc - 1) {
+    fprintf(stderr, "usage: %s [-r repeats] corpus.txt\n", argv[0]);
+    return 1;
+  }
+  if (repeats < 1) repeats = 1;
+
+  const std::vector<UriPair> pairs = ReadUriPairs(argv[optind]);
+  std::vector<WidePair> wide(pairs.size());
+  std::vector<ParsedPair<UriUriA> > narrowParsed(pairs.size());
+  std::vector<ParsedPair<UriUriW> > wideParsed(pairs.size());
+  memset(narrowParsed.data(), 0,
+         narrowParsed.size() * sizeof(ParsedPair<UriUriA>));
+  memset(wideParsed.data(), 0, wideParsed.size() * sizeof(ParsedPair<UriUriW>));
+
+  double widenSeconds = 0;
+  Stages narrow;
+  Stages wideStages;
+  size_t narrowResolved = 0;
+  size_t wideResolved = 0;
+
+  for (int r = 0; r < repeats; r++) {
+    double start = bench_now();
+    for (size_t i = 0; i < pairs.size(); i++) {
+      WidenUtf8(pairs[i].base, &wide[i].base);
+      WidenUtf8(pairs[i].relative, &wide[i].relative);
+    }
+    widenSeconds += bench_now() - start;
+
+    narrowResolved += runNarrow(pairs, &narrowParsed, &narrow);
+    wideResolved += runWide(wide, &wideParsed, &wideStages);
+  }
+
+  const double total = (double)pairs.size() * repeats;
+  printf("pairs: %zu, repeats: %d, resolved: %zu (A) %zu (W)\n", pairs.size(),
+         repeats, narrowResolved / repeats, wideResolved / repeats);
+  printf("%-12s %14s %14s\n", "stage", "A pairs/sec", "W pairs/sec");
+  printf("%-12s %14s %14.0f\n", "widen", "", rate(total, widenSeconds));
+  const char *names[] = {"parse", "normalize", "resolve", "free"};
+  const double narrowSeconds[] = {narrow.parse, narrow.normalize,
+                                  narrow.resolve, narrow.free};
+  const double wideSeconds[] = {wideStages.parse, wideStages.normalize,
+                                wideStages.resolve, wideStages.free};
+  double narrowTotal = 0;
+  double wideTotal = 0;
+  for (int i = 0; i < 4; i++) {
+    printf("%-12s %14.0f %14.0f\n", names[i], rate(total, narrowSeconds[i]),
+           rate(total, wideSeconds[i]));
+    narrowTotal += narrowSeconds[i];
+    wideTotal += wideSeconds[i];
+  }
+  printf("%-12s %14.0f %14.0f\n", "total", rate(total, narrowTotal),
+         rate(total, wideTotal));
+  printf("%-12s %14s %14.0f\n", "widen + W", "",
+         rate(total, widenSeconds + wideTotal));
+
+  return 0;
+}
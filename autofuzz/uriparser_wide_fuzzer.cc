@@ -0,0 +1,14 @@
+// uriparser_raw_fuzzer through the wchar_t API: the same raw layout (see
+// DecodeRawInput()) is decoded as UTF-8 into wide strings once, then parsed,
+// serialized, compared, normalized and resolved with the ...W functions.
+// Corpora are interchangeable with uriparser_raw_fuzzer.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "uriparser_fuzz_common.h"
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+  FuzzUriParserW(DecodeRawInput(data, size));
+  return 0;
+}